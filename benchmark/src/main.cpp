@@ -0,0 +1,34 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofApp.h"
+
+//========================================================================
+// benchmark [--sizes=1000,10000] [--fanout=8] [--depth=0] [--frames=20] [--events=200] [--seed=0] [--out=results.jsonl] [--label=v1.2]
+int main(int argc, char* argv[]){
+	ofApp::Settings settings;
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		auto eq = arg.find('=');
+		string key = arg.substr(0, eq);
+		string value = eq == string::npos ? "" : arg.substr(eq + 1);
+		if (key == "--sizes") {
+			settings.sizes.clear();
+			for (auto& s : ofSplitString(value, ",", true, true)) settings.sizes.push_back(ofToInt(s));
+		}
+		else if (key == "--fanout") settings.fanOut = MAX(1, ofToInt(value));
+		else if (key == "--depth") settings.maxDepth = MAX(0, ofToInt(value));
+		else if (key == "--frames") settings.frames = MAX(1, ofToInt(value));
+		else if (key == "--events") settings.events = MAX(1, ofToInt(value));
+		else if (key == "--seed") settings.seed = ofToInt(value);
+		else if (key == "--out") settings.output = value;
+		else if (key == "--label") settings.label = value;
+		else ofLogWarning("benchmark") << "unknown option " << arg;
+	}
+
+	// no window, benchmarks only use the component core
+	ofAppNoWindow window;
+	ofSetupOpenGL(&window, 1024, 768, OF_WINDOW);
+	// components read the oF clock (timers, update rates), it advances by a fixed step per frame instead of the wall clock
+	ofSetTimeModeFixedRate(ofGetFixedStepForFps(60));
+	ofRunApp(new ofApp(settings));
+}
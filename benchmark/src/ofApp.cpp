@@ -0,0 +1,219 @@
+#include "ofApp.h"
+
+namespace {
+	// plain component, benchmarks only need the tree
+	class BenchComponent : public ofxComponentBase {
+	};
+
+	double nowMicros() {
+		return chrono::duration<double, micro>(chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+//--------------------------------------------------------------
+ofApp::ofApp(const Settings& _settings)
+: settings(_settings)
+{
+}
+
+//--------------------------------------------------------------
+void ofApp::setup(){
+	if (!settings.output.empty()) {
+		output.open(ofToDataPath(settings.output, true), ios::app);
+		if (!output) ofLogWarning("benchmark") << "can't open " << settings.output;
+	}
+
+	manager = make_shared<ofxComponentManager>();
+	manager->setRect(ofRectangle(0, 0, 1024, 768));
+	// listen to the fake mouse events of benchmarkHitTest()
+	manager->setup();
+
+	for (int n : settings.sizes) {
+		// same tree for the same settings
+		ofSeedRandom(settings.seed + n);
+
+		double begin = nowMicros();
+		buildTree(n);
+		report("build", "addChild+start", "us/node", (nowMicros() - begin) / numNodes);
+
+		benchmarkUpdate(settings.frames);
+		benchmarkTransforms(settings.frames);
+		benchmarkHitTest(settings.events);
+		benchmarkTimers();
+		benchmarkInsertRemove(MIN(n, 10000));
+		benchmarkDestroy();
+	}
+
+	ofExit(0);
+}
+
+//--------------------------------------------------------------
+void ofApp::buildTree(int _numNodes){
+	clearTree();
+
+	// breadth first, so the tree is as shallow as fanOut allows.
+	// With maxDepth, the manager takes another subtree when all parents are full.
+	vector<pair<ofxComponentBase*, int> > parents;
+	size_t next = 0;
+	depth = 0;
+	numNodes = _numNodes;
+	while ((int)nodes.size() < numNodes) {
+		if (next == parents.size()) parents.push_back(make_pair(manager.get(), 0));
+		auto p = parents[next++];
+		if (settings.maxDepth > 0 && p.second >= settings.maxDepth) continue;
+
+		for (int i = 0; i < settings.fanOut && (int)nodes.size() < numNodes; ++i) {
+			auto c = make_shared<BenchComponent>();
+			c->setRect(ofRandom(0, 100), ofRandom(0, 100), 50, 50);
+			c->setRotation(ofRandom(-10, 10));
+			p.first->addChild(c);
+			nodes.push_back(c);
+			parents.push_back(make_pair(c.get(), p.second + 1));
+			depth = MAX(depth, p.second + 1);
+		}
+	}
+
+	// start all
+	ofEventArgs args;
+	manager->update(args);
+}
+
+//--------------------------------------------------------------
+void ofApp::clearTree(){
+	manager->removeAllChildren();
+	nodes.clear();
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkUpdate(int frames){
+	ofEventArgs args;
+	double begin = nowMicros();
+	for (int f = 0; f < frames; ++f) {
+		manager->update(args);
+	}
+	report("update", "recursive", "us/frame", (nowMicros() - begin) / frames);
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkTransforms(int frames){
+	for (bool useStore : {false, true}) {
+		manager->setTransformStoreEnabled(useStore);
+
+		// warm up
+		for (auto& c : nodes) c->getGlobalPos();
+
+		// every frame: move the top level, which makes the whole tree dirty, then read every global position
+		double begin = nowMicros();
+		float sum = 0;
+		for (int f = 0; f < frames; ++f) {
+			for (auto c : manager->getChildrenView()) {
+				c->setPos(f, f);
+			}
+			for (auto& c : nodes) {
+				sum += c->getGlobalPos().x;
+			}
+		}
+		double usPerFrame = (nowMicros() - begin) / frames;
+
+		// keeps the reads from being optimized out
+		if (sum == -1) cout << sum << endl;
+		report("transforms", useStore ? "store" : "recursive", "us/frame", usPerFrame);
+	}
+
+	manager->setTransformStoreEnabled(false);
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkHitTest(int events){
+	vector<ofVec2f> positions(events);
+	for (auto& p : positions) p.set(ofRandom(0, 1024), ofRandom(0, 768));
+
+	for (int variant = 0; variant < 2; ++variant) {
+		manager->setSpatialIndexEnabled(variant == 1);
+
+		// warm up, builds the index
+		ofEvents().notifyMouseMoved(0, 0);
+
+		double begin = nowMicros();
+		for (auto& p : positions) {
+			ofEvents().notifyMouseMoved(p.x, p.y);
+		}
+		report("hitTest", variant == 1 ? "spatialIndex" : "linear", "us/event", (nowMicros() - begin) / events);
+	}
+
+	manager->setSpatialIndexEnabled(false);
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkTimers(){
+	ofEventArgs args;
+	double begin = nowMicros();
+	manager->update(args);
+	double updateOnly = nowMicros() - begin;
+
+	int fired = 0;
+	begin = nowMicros();
+	for (auto& c : nodes) {
+		c->addTimerFunction([&fired] { ++fired; }, 0);
+	}
+	report("timers", "schedule", "us/timer", (nowMicros() - begin) / nodes.size());
+
+	// without the update of the tree itself
+	begin = nowMicros();
+	manager->update(args);
+	report("timers", "run", "us/timer", MAX(0.0, nowMicros() - begin - updateOnly) / nodes.size());
+
+	if (fired != (int)nodes.size()) {
+		ofLogWarning("benchmark") << "timers: " << fired << " of " << nodes.size() << " fired";
+	}
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkInsertRemove(int count){
+	vector<shared_ptr<ofxComponentBase> > targets(count);
+	for (auto& c : targets) c = nodes[(size_t)ofRandom(nodes.size() - 1)];
+
+	for (bool front : {false, true}) {
+		double begin = nowMicros();
+		for (auto& c : targets) {
+			auto p = c->getParent();
+			p->removeChild(c);
+			if (front) p->insertChild(c, 0);
+			else p->addChild(c);
+		}
+		report("insertRemove", front ? "insertFront" : "append", "us/op", (nowMicros() - begin) / count);
+	}
+}
+
+//--------------------------------------------------------------
+void ofApp::benchmarkDestroy(){
+	// only the tree owns them now, so removing them deletes them
+	nodes.clear();
+
+	double begin = nowMicros();
+	for (auto c : manager->getChildren()) {
+		c->destroy();
+	}
+	report("destroy", "destroy", "us/node", (nowMicros() - begin) / numNodes);
+
+	begin = nowMicros();
+	manager->flushDestroyedObjects();
+	report("destroy", "remove", "us/node", (nowMicros() - begin) / numNodes);
+}
+
+//--------------------------------------------------------------
+void ofApp::report(const string& benchmark, const string& variant, const string& metric, double value){
+	stringstream ss;
+	ss << "{\"benchmark\":\"" << benchmark << "\""
+		<< ",\"variant\":\"" << variant << "\""
+		<< ",\"nodes\":" << numNodes
+		<< ",\"fanOut\":" << settings.fanOut
+		<< ",\"depth\":" << depth
+		<< ",\"seed\":" << settings.seed
+		<< ",\"metric\":\"" << metric << "\""
+		<< ",\"value\":" << value
+		<< ",\"label\":\"" << settings.label << "\"}";
+
+	cout << ss.str() << endl;
+	if (output.is_open()) output << ss.str() << endl;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxComponent.h"
+
+using namespace ofxComponent;
+
+// Headless benchmarks for the component core.
+// Runs once in setup() and exits.
+// Results are printed as one JSON object per line, and appended to settings.output if set.
+class ofApp : public ofBaseApp {
+public:
+	struct Settings {
+		vector<int> sizes = { 1000, 10000, 100000, 1000000 };
+		int fanOut = 8;
+		int maxDepth = 0; // 0 for as shallow as fanOut allows
+		int frames = 20;
+		int events = 200;
+		int seed = 0;     // with the size, picks the tree, the mouse positions and the nodes to move
+		string output;
+		string label;     // free text copied to every result, like a version or commit
+	};
+
+	ofApp(const Settings& settings);
+	void setup();
+
+private:
+	// build a tree of numNodes components under manager
+	void buildTree(int numNodes);
+	void clearTree();
+
+	// ofxComponentManager::update() of the whole tree
+	void benchmarkUpdate(int frames);
+	// Global matrix propagation, recursive path vs ofxComponentTransformStore
+	void benchmarkTransforms(int frames);
+	// Topmost component under a fake mouse, linear vs ofxComponentSpatialIndex
+	void benchmarkHitTest(int events);
+	// addTimerFunction() on every node, then one update that runs them all
+	void benchmarkTimers();
+	// removeChild() and addChild() back, on random nodes
+	void benchmarkInsertRemove(int count);
+	// destroy() the whole tree and remove it. Leaves the tree empty
+	void benchmarkDestroy();
+
+	void report(const string& benchmark, const string& variant, const string& metric, double value);
+
+	Settings settings;
+	shared_ptr<ofxComponentManager> manager;
+	vector<shared_ptr<ofxComponentBase> > nodes;
+	int numNodes = 0;
+	int depth = 0;
+	ofstream output;
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include "ofMain.h"
+
+namespace ofxComponent {
+	// 2x3 affine transform for component transforms (translate, rotate, scale).
+	// Same row vector convention as ofMatrix4x4:
+	//   x' = x * a + y * c + tx
+	//   y' = x * b + y * d + ty
+	// and A * B means "A, then B".
+	class ofxComponentAffine2D {
+	public:
+		float a = 1, b = 0;
+		float c = 0, d = 1;
+		float tx = 0, ty = 0;
+
+		ofxComponentAffine2D() {}
+		ofxComponentAffine2D(float _a, float _b, float _c, float _d, float _tx, float _ty)
+			: a(_a), b(_b), c(_c), d(_d), tx(_tx), ty(_ty) {}
+
+		ofxComponentAffine2D operator*(const ofxComponentAffine2D& m) const {
+			return ofxComponentAffine2D(
+				a * m.a + b * m.c,
+				a * m.b + b * m.d,
+				c * m.a + d * m.c,
+				c * m.b + d * m.d,
+				tx * m.a + ty * m.c + m.tx,
+				tx * m.b + ty * m.d + m.ty);
+		}
+
+		ofVec2f apply(float x, float y) const {
+			return ofVec2f(x * a + y * c + tx, x * b + y * d + ty);
+		}
+		ofVec2f apply(const ofVec2f& p) const {
+			return apply(p.x, p.y);
+		}
+
+		float getDeterminant() const {
+			return a * d - b * c;
+		}
+
+		// closed form, identity if not invertible (zero scale)
+		ofxComponentAffine2D getInverse() const {
+			float det = getDeterminant();
+			if (det == 0) return ofxComponentAffine2D();
+			float inv = 1.0f / det;
+			float ia = d * inv, ib = -b * inv, ic = -c * inv, id = a * inv;
+			return ofxComponentAffine2D(ia, ib, ic, id,
+				-(tx * ia + ty * ic),
+				-(tx * ib + ty * id));
+		}
+
+		// uniform scale only, like the components use
+		float getScale() const {
+			return sqrtf(a * a + b * b);
+		}
+
+		// degrees
+		float getRotation() const {
+			return atan2f(b, a) * RAD_TO_DEG;
+		}
+
+		// z scale follows the xy scale, as ofMatrix4x4::scale(s, s, s) did
+		ofMatrix4x4 toMatrix() const {
+			return ofMatrix4x4(
+				a, b, 0, 0,
+				c, d, 0, 0,
+				0, 0, getScale(), 0,
+				tx, ty, 0, 1);
+		}
+	};
+}
@@ -1,10 +1,36 @@
 #include "ofxComponentBase.h"
+#include "ofxComponentSpatialIndex.h"
+#include "ofxComponentTransformStore.h"
+#include "ofxComponentTimerScheduler.h"
+#include "ofxComponentRegistry.h"
+#include "ofxComponentParallelUpdater.h"
+#include "ofxComponentClipStack.h"
+#include "ofxComponentFboPool.h"
+#include "ofxComponentProfiler.h"
 
 using namespace ofxComponent;
-vector<shared_ptr<ofxComponentBase> > ofxComponentBase::allComponents;
+ofxComponentSpatialIndex* ofxComponentBase::spatialIndex = nullptr;
+ofxComponentTransformStore* ofxComponentBase::transformStore = nullptr;
+ofxComponentParallelUpdater* ofxComponentBase::parallelUpdater = nullptr;
+ofxComponentFboPool* ofxComponentBase::fboPool = nullptr;
+unsigned int ofxComponentBase::parallelStamp = 0;
+// never deleted, components may be destroyed after other statics
+ofxComponentTimerScheduler& ofxComponentBase::timerScheduler = *new ofxComponentTimerScheduler();
+unsigned int ofxComponentBase::structureVersion = 0;
+unsigned int ofxComponentBase::mouseVersion = 1;
+unsigned int ofxComponentBase::inputVersion = 0;
+unsigned int ofxComponentBase::drawVersion = 0;
+unsigned int ofxComponentBase::drawInterestVersion = 0;
+int ofxComponentBase::numCaching = 0;
+bool ofxComponentBase::culling = false;
+ofRectangle ofxComponentBase::cullRect;
+int ofxComponentBase::numSleeping = 0;
+unsigned int ofxComponentBase::inputInterestVersion = 0;
+ofxComponentRegistry ofxComponentBase::allComponents;
 vector<shared_ptr<ofxComponentBase> > ofxComponentBase::destroyedComponents;
-shared_ptr<ofxComponentBase> ofxComponentBase::movingComponent = nullptr;
-shared_ptr<ofxComponentBase>  ofxComponentBase::mouseOverComponent = nullptr;
+ofxComponentBase* ofxComponentBase::movingComponent = nullptr;
+ofxComponentBase* ofxComponentBase::pressedOverComponent = nullptr;
+ofxComponentBase* ofxComponentBase::mouseOverComponent = nullptr;
 
 // ========================================================
 // ofxComponentBase
@@ -14,6 +40,25 @@ ofxComponentBase::ofxComponentBase() {
 }
 
 ofxComponentBase::~ofxComponentBase() {
+    if (sleeping) --numSleeping;
+    if (cacheAsBitmap) --numCaching;
+    if (spatialIndex) spatialIndex->remove(this);
+    if (transformStore && transformIndex >= 0) transformStore->remove(transformIndex);
+    if (mouseOverComponent == this) mouseOverComponent = nullptr;
+    if (movingComponent == this) movingComponent = nullptr;
+    if (pressedOverComponent == this) pressedOverComponent = nullptr;
+    
+    // the scheduler may still hold them, recycled slots never come back to this
+    if (cold) {
+        for (auto& t : cold->timerFunctions) {
+            timerScheduler.release(t);
+        }
+    }
+}
+
+const ofxComponentTypeInfo& ofxComponentBase::staticType() {
+    static const ofxComponentTypeInfo info("ofxComponentBase", nullptr);
+    return info;
 }
 
 void ofxComponentBase::setup() {
@@ -34,11 +79,158 @@ void ofxComponentBase::update(ofEventArgs& args) {
     
     if (!isActive) return;
     
-    onUpdate();
+    if (sleeping) {
+        updateRequestedOnly(args);
+        return;
+    }
+    updateRequested = false;
+    childUpdateRequested = false;
+    
+    bool due;
+    if (parallelUpdatedStamp != 0 && parallelUpdatedStamp == parallelStamp) {
+        // onUpdate() was done in the parallel phase of this frame
+        due = parallelDue;
+        parallelUpdatedStamp = 0;
+    }
+    else {
+        due = isUpdateDue();
+        if (due) OFX_COMPONENT_PROFILE(this, ProfileUpdate, onUpdate());
+    }
     for (int i = 0; i < children.size(); ++i) {
         children[i]->update(args);
     }
-    postUpdate();
+    if (due) OFX_COMPONENT_PROFILE(this, ProfilePostUpdate, postUpdate());
+}
+
+void ofxComponentBase::updateParallel(ofxComponentParallelUpdater& updater) {
+    // onUpdate() only, start, timers and postUpdate() are done by update() on the main thread
+    if (destroyed || needStartExec || !isActive || sleeping) return;
+    
+    parallelDue = isUpdateDue();
+    parallelUpdatedStamp = parallelStamp;
+    if (parallelDue) OFX_COMPONENT_PROFILE(this, ProfileUpdate, onUpdate());
+    
+    bool globalReady = false;
+    for (auto& c : children) {
+        // the tree can't change during the phase
+        if (!c->getThreadSafeUpdate()) {
+            c->updateParallel(updater);
+            continue;
+        }
+        if (!globalReady) {
+            // other threads read it, compute it now so they don't write it
+            updateGlobalMatrixInverse();
+            globalReady = true;
+        }
+        updater.spawn(c.get());
+    }
+}
+
+void ofxComponentBase::setThreadSafeUpdate(bool threadSafe) {
+    threadSafeUpdate = threadSafe;
+}
+
+bool ofxComponentBase::isInParallelUpdate() {
+    return parallelUpdater && parallelUpdater->isInTask();
+}
+
+bool ofxComponentBase::isUpdateDue() {
+    switch (updatePolicy) {
+    case UpdateEveryNFrames:
+        return (ofGetFrameNum() + updatePhase) % updateInterval == 0;
+    case UpdateFixedRate: {
+        float now = ofGetElapsedTimef();
+        if (now < nextUpdateTime) return false;
+        nextUpdateTime += updatePeriod;
+        // too far behind (was inactive, or a long frame), don't catch up
+        if (nextUpdateTime <= now) nextUpdateTime = now + updatePeriod;
+        return true;
+    }
+    default:
+        return true;
+    }
+}
+
+void ofxComponentBase::updateRequestedOnly(ofEventArgs& args) {
+    // sleeping subtree, walk only down to the components that asked for an update
+    bool self = updateRequested;
+    bool below = childUpdateRequested;
+    updateRequested = false;
+    childUpdateRequested = false;
+    
+    if (self) OFX_COMPONENT_PROFILE(this, ProfileUpdate, onUpdate());
+    if (below) {
+        for (int i = 0; i < children.size(); ++i) {
+            auto c = children[i].get();
+            if (c->destroyed) continue;
+            if (c->needStartExec) c->start();
+            c->updateTimers();
+            if (!c->isActive) continue;
+            c->updateRequestedOnly(args);
+        }
+    }
+    if (self) OFX_COMPONENT_PROFILE(this, ProfilePostUpdate, postUpdate());
+}
+
+void ofxComponentBase::setUpdateEveryFrame() {
+    updatePolicy = UpdateEveryFrame;
+}
+
+void ofxComponentBase::setUpdateEveryNFrames(int n) {
+    if (n < 1) {
+        ofLogWarning() << "setUpdateEveryNFrames(): invalid interval " << n;
+        return;
+    }
+    static uint64_t phaseCount = 0;
+    updatePolicy = UpdateEveryNFrames;
+    updateInterval = n;
+    updatePhase = phaseCount++;
+}
+
+void ofxComponentBase::setUpdateRate(float hz) {
+    if (!isfinite(hz) || hz <= 0) {
+        ofLogWarning() << "setUpdateRate(): invalid rate " << hz;
+        return;
+    }
+    updatePolicy = UpdateFixedRate;
+    updatePeriod = 1.0f / hz;
+    nextUpdateTime = ofGetElapsedTimef();
+}
+
+void ofxComponentBase::sleep() {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self] { self->sleep(); });
+        return;
+    }
+    if (sleeping) return;
+    sleeping = true;
+    ++numSleeping;
+}
+
+void ofxComponentBase::wake() {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self] { self->wake(); });
+        return;
+    }
+    if (!sleeping) return;
+    sleeping = false;
+    --numSleeping;
+}
+
+void ofxComponentBase::requestUpdate() {
+    if (numSleeping == 0) return;
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self] { self->requestUpdate(); });
+        return;
+    }
+    updateRequested = true;
+    // all the way up, flags of components that were not updated may be stale
+    for (auto p = parent.get(); p; p = p->parent.get()) {
+        p->childUpdateRequested = true;
+    }
 }
 
 void ofxComponentBase::draw(ofEventArgs& args) {
@@ -46,49 +238,147 @@ void ofxComponentBase::draw(ofEventArgs& args) {
     
     if (!isActive || destroyed) return;
     
+    // out of view, skip the subtree, or only this one if children may draw outside
+    // constrained and cached ones clip their children to the rect anyway
+    bool clipsChildren = constrain || cacheAsBitmap;
+    bool inView = !culling || isInView();
+    if (!inView && (clipsChildren || !childrenDrawOutside)) return;
+    
     ofPushMatrix();
     ofMatrix4x4 mat = getLocalMatrix();
     ofMultMatrix(mat);
 
-// draw in constrainFbo
+// cached subtree, draw the texture only
+bool isCurrentCache = cacheAsBitmap;
+if (isCurrentCache && cacheValid && constrainFbo && constrainFbo->isAllocated() &&
+    getWidth() == constrainFbo->getWidth() && getHeight() == constrainFbo->getHeight()) {
+    constrainFbo->draw(0, 0);
+    ofPopMatrix();
+    return;
+}
+
+// clip by scissor if it is still a rectangle on screen
 bool isCurrentConstrain = constrain;
-if (isCurrentConstrain) {
+bool isCurrentScissor = false;
+if (isCurrentConstrain && constrainMode == ConstrainScissor && !isCurrentCache) {
+    ofRectangle scissor;
+    if (ofxComponentClipStack::getScissorRect(getWidth(), getHeight(), scissor)) {
+        ofxComponentClipStack::push(scissor);
+        isCurrentScissor = true;
+    }
+}
+
+// draw in constrainFbo, or a shared one of the pool
+// the cache needs its own fbo, that is kept
+bool isCurrentFbo = isCurrentCache || (isCurrentConstrain && !isCurrentScissor);
+ofFbo* fbo = nullptr;
+if (isCurrentFbo && fboPool && !isCurrentCache) {
+    fbo = fboPool->acquire(getWidth(), getHeight());
+}
+else if (isCurrentFbo) {
+    if (!constrainFbo) constrainFbo = make_unique<ofFbo>();
+    
     // resize fbo if needed
     if (getWidth() > 0 && getHeight() > 0 &&
-        (getWidth() != constrainFbo.getWidth() || getHeight() != constrainFbo.getHeight())) {
-        constrainFbo.allocate(getWidth(), getHeight());
+        (getWidth() != constrainFbo->getWidth() || getHeight() != constrainFbo->getHeight())) {
+        constrainFbo->allocate(getWidth(), getHeight());
     }
 
-    if (!constrainFbo.isAllocated()) {
-        constrainFbo.allocate(MAX(1, getWidth()), MAX(1, getHeight()));
+    if (!constrainFbo->isAllocated()) {
+        constrainFbo->allocate(MAX(1, getWidth()), MAX(1, getHeight()));
     }
+    fbo = constrainFbo.get();
+}
+
+// not drawn in its own fbo anymore (constrain off, scissor or pooled)
+if (constrainFbo && fbo != constrainFbo.get()) constrainFbo.reset();
+
+// valid from here, changes while drawing invalidate it again
+if (isCurrentCache) cacheValid = true;
 
-    // draw in fbo
-    constrainFbo.begin();
+if (isCurrentFbo) {
+    // draw in fbo, scissors of outside don't apply in it
+    ofxComponentClipStack::beginSurface();
+    fbo->begin();
     ofClear(0, 0, 0, 0);
 }
 
-ofPushStyle();
-onDraw();
-ofPopStyle();
+if (inView) {
+    ofPushStyle();
+    OFX_COMPONENT_PROFILE(this, ProfileDraw, onDraw());
+    ofPopStyle();
+}
+
+// children are culled to the rect, the whole cache is drawn wherever it is
+ofRectangle outerCullRect = cullRect;
+if (culling && clipsChildren) {
+    const ofRectangle& bounds = getCachedGlobalBounds();
+    if (isCurrentCache) {
+        cullRect = bounds;
+    }
+    else {
+        float x0 = MAX(bounds.getMinX(), cullRect.getMinX());
+        float y0 = MAX(bounds.getMinY(), cullRect.getMinY());
+        float x1 = MIN(bounds.getMaxX(), cullRect.getMaxX());
+        float y1 = MIN(bounds.getMaxY(), cullRect.getMaxY());
+        cullRect.set(x0, y0, x1 - x0, y1 - y0);
+    }
+}
 
 for (int i = 0; i < children.size(); ++i) {
     auto& c = children[i];
     c->draw(args);
 }
 
-ofPushStyle();
-postDraw();
-ofPopStyle();
+cullRect = outerCullRect;
 
-if (isCurrentConstrain) {
-    constrainFbo.end();
-    constrainFbo.draw(0, 0);
+if (inView) {
+    ofPushStyle();
+    OFX_COMPONENT_PROFILE(this, ProfilePostDraw, postDraw());
+    ofPopStyle();
+}
+
+if (isCurrentScissor) {
+    ofxComponentClipStack::pop();
+}
+if (isCurrentFbo) {
+    fbo->end();
+    ofxComponentClipStack::endSurface();
+    if (fbo == constrainFbo.get()) {
+        constrainFbo->draw(0, 0);
+    }
+    else {
+        // pooled ones are bigger, only the rect is drawn
+        int w = MAX(1, (int)getWidth()), h = MAX(1, (int)getHeight());
+        fbo->getTexture().drawSubsection(0, 0, w, h, 0, 0, w, h);
+        fboPool->release(fbo);
+    }
 }
 
 ofPopMatrix();
 }
 
+void ofxComponentBase::setDrawInterest(bool onDraw, bool postDraw) {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self, onDraw, postDraw] { self->setDrawInterest(onDraw, postDraw); });
+        return;
+    }
+    drawInterestDeclared = true;
+    if (drawsOnDraw == onDraw && drawsPostDraw == postDraw) return;
+    drawsOnDraw = onDraw;
+    drawsPostDraw = postDraw;
+    ++drawInterestVersion;
+}
+
+void ofxComponentBase::notDrawing(bool post) {
+    if (drawInterestDeclared) return;
+    bool& draws = post ? drawsPostDraw : drawsOnDraw;
+    if (!draws) return;
+    draws = false;
+    ++drawInterestVersion;
+}
+
 void ofxComponentBase::exit(ofEventArgs& args) {
     onExit();
     for (int i = 0; i < children.size(); ++i) {
@@ -99,7 +389,7 @@ void ofxComponentBase::exit(ofEventArgs& args) {
 
 void ofxComponentBase::start() {
     if (!destroyed) {
-        allComponents.push_back(shared_from_this());
+        handle = allComponents.insert(shared_from_this());
     }
 
     needStartExec = false;
@@ -107,14 +397,34 @@ void ofxComponentBase::start() {
 }
 
 void ofxComponentBase::setActive(bool active) {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self, active] { self->setActive(active); });
+        return;
+    }
     if (isActive == active) return;
-    bool beforeGlobal = getGlobalActive();
     isActive = active;
+    ++inputVersion;
+    ++drawVersion;
+    if (parent) parent->invalidateCache();
+    if (active) requestUpdate();
     onActiveChanged(active);
-    bool afterGlobal = getGlobalActive();
+    updateGlobalActive();
+}
 
-    if (afterGlobal != beforeGlobal) {
-        globalActiveChanged(afterGlobal);
+void ofxComponentBase::updateGlobalActive() {
+    bool active = isActive && (parent == nullptr || parent->globalActive);
+    if (active == globalActive) return;
+    
+    // flags of the whole subtree first, so the callbacks read the new state anywhere
+    setGlobalActiveFlag(active);
+    if (!destroyed) globalActiveChanged(active);
+}
+
+void ofxComponentBase::setGlobalActiveFlag(bool _globalActive) {
+    globalActive = _globalActive;
+    for (auto& c : children) {
+        if (c->isActive) c->setGlobalActiveFlag(_globalActive);
     }
 }
 
@@ -128,53 +438,109 @@ void ofxComponentBase::globalActiveChanged(bool _globalActive) {
     }
 }
 
-shared_ptr<ofxComponentBase::Timer> ofxComponentBase::addTimerFunction(TimerFunc func, float wait) {
-    auto timer = make_shared<Timer>(func, wait);
+ofxComponentBase::TimerRef ofxComponentBase::addTimerFunction(TimerFunc func, float wait) {
+    TimerHandle handle;
+    Timer* timer = createTimer(wait, handle);
+    timer->function.assign(func);
+    startTimer(timer);
+    return TimerRef(handle);
+}
+
+ofxComponentBase::Timer* ofxComponentBase::createTimer(float wait, TimerHandle& handle) {
+    static uint64_t timerCount = 0;
+    
+    // the pool is shared, the timer is started after the parallel phase
+    unique_lock<mutex> lock;
+    if (isInParallelUpdate()) lock = unique_lock<mutex>(parallelUpdater->getMutex());
+    
+    Timer* timer = timerScheduler.create(handle);
+    timer->owner = this;
+    timer->id = ++timerCount;
+    timer->execTime = ofGetElapsedTimef() + wait;
+    return timer;
+}
+
+void ofxComponentBase::startTimer(Timer* timer) {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        TimerHandle handle;
+        handle.index = timer->index;
+        handle.generation = timer->generation;
+        parallelUpdater->defer([self, handle] {
+            Timer* t = timerScheduler.get(handle);
+            if (t) self->startTimer(t);
+        });
+        return;
+    }
     
     // Set the paused state to match the current component state
     if (timerPaused) {
         timer->setPaused(true);
     }
     
-    timerFunctionsToAdd.push_back(timer);
-    return timer;
+    // recycle finished timers before the vector grows
+    auto& timerFunctions = getCold().timerFunctions;
+    if (timerFunctions.size() == timerFunctions.capacity()) {
+        removeDoneTimers();
+    }
+    
+    TimerHandle handle;
+    handle.index = timer->index;
+    handle.generation = timer->generation;
+    timerFunctions.push_back(handle);
+    timer->reschedule();
 }
 
 void ofxComponentBase::updateTimers() {
-    // 1) 追加予約中のタイマーがあれば、ここでまとめて本体に移してしまう
-    if (!timerFunctionsToAdd.empty()) {
-        for (auto& t : timerFunctionsToAdd) {
-            timerFunctions.push_back(t);
-        }
-        timerFunctionsToAdd.clear();
-    }
-
-    // 2) 実行するタイマーを一旦配列に集める（配列破壊防止）
-    vector<shared_ptr<Timer>> toRun;
-    if (!timerFunctions.empty()) {
-        float now = ofGetElapsedTimef();
-        for (auto& timer : timerFunctions) {
-            // ここで checkAndRunIfElapsed
-            //timer->checkAndRunIfElapsed(now);
-            if (timer->checkElapsed(now)) {
-                toRun.push_back(timer);
+    // timerScheduler has delivered elapsed timers only
+    if (!cold || cold->dueTimers.empty()) return;
+    
+    auto& runningTimers = cold->runningTimers;
+    runningTimers.swap(cold->dueTimers);
+    
+    // recycled since delivered
+    runningTimers.erase(
+        remove_if(
+            runningTimers.begin(),
+            runningTimers.end(),
+            [](const TimerHandle &h) {
+                return timerScheduler.get(h) == nullptr;
             }
-        }
-    }
-
-    // 3) タイマーを実行
-    for (auto& timer : toRun) {
-        timer->run();
+        ),
+        runningTimers.end()
+    );
+    
+    // run in the order they were added, as they were listed before
+    sort(runningTimers.begin(), runningTimers.end(), [](const TimerHandle &a, const TimerHandle &b) {
+        return timerScheduler.get(a)->id < timerScheduler.get(b)->id;
+    });
+    
+    for (auto& h : runningTimers) {
+        // slots never move, so this stays valid even if the callback adds timers
+        Timer* timer = timerScheduler.get(h);
+        
+        // paused after delivery, it is scheduled again on resume
+        if (timer == nullptr || timer->isPaused()) continue;
+        OFX_COMPONENT_PROFILE(this, ProfileTimer, timer->run());
     }
-    toRun.clear();
+    runningTimers.clear();
+    
+    removeDoneTimers();
+}
 
-    // 4) 終了済のタイマーを erase する
+void ofxComponentBase::removeDoneTimers() {
+    if (!cold) return;
+    auto& timerFunctions = cold->timerFunctions;
     timerFunctions.erase(
         remove_if(
             timerFunctions.begin(),
             timerFunctions.end(),
-            [](const TimerRef &t) {
-                return t->isDone(); // done のやつは消す
+            [](const TimerHandle &h) {
+                Timer* t = timerScheduler.get(h);
+                if (t == nullptr) return true;
+                if (!t->isDone() || t->running) return false;
+                timerScheduler.release(h);
+                return true;
             }
         ),
         timerFunctions.end()
@@ -183,49 +549,66 @@ void ofxComponentBase::updateTimers() {
 
 vector<ofxComponentBase::TimerRef> ofxComponentBase::getTimerFunctions() {
     vector<TimerRef> result;
-    result.reserve(timerFunctions.size() + timerFunctionsToAdd.size());
-
-    // all timers
-    for (auto &timer : timerFunctions) {
-        result.push_back(timer);
-    }
-    for (auto &timer : timerFunctionsToAdd) {
-        result.push_back(timer);
+    if (!cold) return result;
+    result.reserve(cold->timerFunctions.size());
+    for (auto &h : cold->timerFunctions) {
+        result.push_back(TimerRef(h));
     }
-
     return result;
 }
 
 void ofxComponentBase::clearTimerFunctions() {
-    for (auto &t : timerFunctions) {
-        t->cancel();
-    }
-    for (auto &timer : timerFunctionsToAdd) {
-        timer->cancel();
+    if (!cold) return;
+    for (auto &h : cold->timerFunctions) {
+        Timer* t = timerScheduler.get(h);
+        if (t) t->cancel();
     }
     
     // Don't clear vector, because avoid iteration error.
 }
 
-bool ofxComponentBase::getGlobalActive() {
-    if (getActive()) {
-        auto p = getParent();
-        if (p) {
-            return p->getGlobalActive();
-        }
-        else {
-            return true;
-        }
+ofxComponentBase::ColdData& ofxComponentBase::getCold() {
+    if (!cold) cold = make_unique<ColdData>();
+    return *cold;
+}
+
+ofxComponentBase::MemoryUsage ofxComponentBase::getMemoryUsage() const {
+    MemoryUsage usage;
+    usage.components = 1;
+    usage.base = sizeof(ofxComponentBase);
+    usage.children = children.capacity() * sizeof(children[0]);
+    if (cold) {
+        size_t handles = cold->timerFunctions.capacity() + cold->dueTimers.capacity() + cold->runningTimers.capacity();
+        usage.cold = sizeof(ColdData) + handles * sizeof(TimerHandle);
     }
-    else {
-        return false;
+    if (localMatrixChangedEvents.isCreated()) usage.cold += sizeof(ofEvent<void>);
+    if (mousePressedOverComponentEvents.isCreated()) usage.cold += sizeof(ofEvent<void>);
+    if (constrainFbo) {
+        usage.fbo = sizeof(ofFbo);
+        // RGBA
+        if (constrainFbo->isAllocated()) usage.fbo += (size_t)constrainFbo->getWidth() * (size_t)constrainFbo->getHeight() * 4;
     }
+    return usage;
+}
+
+ofxComponentBase::MemoryUsage ofxComponentBase::getSubtreeMemoryUsage() {
+    MemoryUsage total = getMemoryUsage();
+    walkDescendants([&](ofxComponentBase& c) {
+        MemoryUsage usage = c.getMemoryUsage();
+        total.components += usage.components;
+        total.base += usage.base;
+        total.children += usage.children;
+        total.cold += usage.cold;
+        total.fbo += usage.fbo;
+        return true;
+    });
+    return total;
 }
 
 void ofxComponentBase::keyPressed(ofKeyEventArgs& key) {
-    if (!isActive || !keyMouseEventEnabled) return;
+    if (!isActive || destroyed || !keyMouseEventEnabled) return;
     
-    onKeyPressed(key);
+    OFX_COMPONENT_PROFILE(this, ProfileInput, onKeyPressed(key));
     for (int i = 0; i < children.size(); ++i) {
         auto& c = children[i];
         c->keyPressed(key);
@@ -233,9 +616,9 @@ void ofxComponentBase::keyPressed(ofKeyEventArgs& key) {
 }
 
 void ofxComponentBase::keyReleased(ofKeyEventArgs& key) {
-    if (!isActive || !keyMouseEventEnabled) return;
+    if (!isActive || destroyed || !keyMouseEventEnabled) return;
     
-    onKeyReleased(key);
+    OFX_COMPONENT_PROFILE(this, ProfileInput, onKeyReleased(key));
     for (int i = 0; i < children.size(); ++i) {
         auto& c = children[i];
         c->keyReleased(key);
@@ -243,9 +626,9 @@ void ofxComponentBase::keyReleased(ofKeyEventArgs& key) {
 }
 
 void ofxComponentBase::mouseMoved(ofMouseEventArgs& mouse) {
-    if (!isActive || !keyMouseEventEnabled) return;
+    if (!isActive || destroyed || !keyMouseEventEnabled) return;
     
-    onMouseMoved(mouse);
+    OFX_COMPONENT_PROFILE(this, ProfileInput, onMouseMoved(mouse));
     for (int i = 0; i < children.size(); ++i) {
         auto& c = children[i];
         c->mouseMoved(mouse);
@@ -253,59 +636,78 @@ void ofxComponentBase::mouseMoved(ofMouseEventArgs& mouse) {
 }
 
 void ofxComponentBase::mousePressed(ofMouseEventArgs& mouse) {
-    if (!isActive || !keyMouseEventEnabled) return;
+    if (!isActive || destroyed || !keyMouseEventEnabled) return;
+    
+    handleMousePressed(mouse);
+    
+    for (int i = 0; i < children.size(); ++i) {
+        auto& c = children[i];
+        c->mousePressed(mouse);
+    }
+}
+
+void ofxComponentBase::handleMousePressed(ofMouseEventArgs& mouse) {
+    if (isMouseOver()) requestUpdate();
     
     if (movable && isMouseOver()) {
         setMoving(true);
     }
     
-    onMousePressed(mouse);
+    OFX_COMPONENT_PROFILE(this, ProfileInput, onMousePressed(mouse));
     
     // if this object is top (on mouse)
     if (isMouseOver()) {
         mousePressedOverComponent = true;
-        onMousePressedOverComponent(mouse);
-        ofNotifyEvent(mousePressedOverComponentEvents);
-    }
-    
-    for (int i = 0; i < children.size(); ++i) {
-        auto& c = children[i];
-        c->mousePressed(mouse);
+        pressedOverComponent = this;
+        OFX_COMPONENT_PROFILE(this, ProfileInput, onMousePressedOverComponent(mouse));
+        mousePressedOverComponentEvents.notify();
     }
 }
 
 void ofxComponentBase::mouseDragged(ofMouseEventArgs& mouse) {
-    if (!isActive || !keyMouseEventEnabled) return;
+    if (!isActive || destroyed || !keyMouseEventEnabled) return;
     
+    handleMouseDragged(mouse);
+    for (auto& c : children) {
+        c->mouseDragged(mouse);
+    }
+}
+
+void ofxComponentBase::handleMouseDragged(ofMouseEventArgs& mouse) {
     if (getMoving()) {
         ofVec2f move = getMousePos() - getPreviousMousePos();
         setPos(getPos() + move);
     }
     
-    onMouseDragged(mouse);
-    for (auto& c : children) {
-        c->mouseDragged(mouse);
-    }
+    OFX_COMPONENT_PROFILE(this, ProfileInput, onMouseDragged(mouse));
 }
 
 void ofxComponentBase::mouseReleased(ofMouseEventArgs& mouse) {
     mousePressedOverComponent = false;
 
-    if (!isActive || !keyMouseEventEnabled) return;
+    if (!isActive || destroyed || !keyMouseEventEnabled) return;
     
-    if (getMoving()) setMoving(false);
-    
-    onMouseReleased(mouse);
+    handleMouseReleased(mouse);
     for (int i = 0; i < children.size(); ++i) {
         auto& c = children[i];
         c->mouseReleased(mouse);
     }
 }
 
+void ofxComponentBase::handleMouseReleased(ofMouseEventArgs& mouse) {
+    if (mousePressedOverComponent) requestUpdate();
+    mousePressedOverComponent = false;
+    if (pressedOverComponent == this) pressedOverComponent = nullptr;
+    
+    if (getMoving()) setMoving(false);
+    
+    OFX_COMPONENT_PROFILE(this, ProfileInput, onMouseReleased(mouse));
+}
+
 void ofxComponentBase::mouseScrolled(ofMouseEventArgs& mouse) {
-    if (!isActive || !keyMouseEventEnabled) return;
+    if (!isActive || destroyed || !keyMouseEventEnabled) return;
     
-    onMouseScrolled(mouse);
+    OFX_COMPONENT_PROFILE(this, ProfileInput, onMouseScrolled(mouse));
     for (int i = 0; i < children.size(); ++i) {
         auto& c = children[i];
         c->mouseScrolled(mouse);
@@ -313,9 +715,9 @@ void ofxComponentBase::mouseScrolled(ofMouseEventArgs& mouse) {
 }
 
 void ofxComponentBase::dragEvent(ofDragInfo& dragInfo) {
-    if (!isActive || !keyMouseEventEnabled) return;
+    if (!isActive || destroyed || !keyMouseEventEnabled) return;
     
-    onDragEvent(dragInfo);
+    OFX_COMPONENT_PROFILE(this, ProfileInput, onDragEvent(dragInfo));
     for (int i = 0; i < children.size(); ++i) {
         auto& c = children[i];
         c->dragEvent(dragInfo);
@@ -323,29 +725,48 @@ void ofxComponentBase::dragEvent(ofDragInfo& dragInfo) {
 }
 
 bool ofxComponentBase::isMouseInside() {
-    return inside(getMouseX(), getMouseY());
-}
-
-bool ofxComponentBase::isMouseOver() {
-    return mouseOverComponent == shared_from_this();
-}
-
-bool ofxComponentBase::isMousePressedOverComponent() {
-    return mousePressedOverComponent;
+    updateLocalMouse();
+    return inside(localMouse.x, localMouse.y);
 }
 
 void ofxComponentBase::setKeyMouseEventEnabled(bool enabled) {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self, enabled] { self->setKeyMouseEventEnabled(enabled); });
+        return;
+    }
+    if (keyMouseEventEnabled == enabled) return;
     keyMouseEventEnabled = enabled;
+    ++inputVersion;
 }
 
 bool ofxComponentBase::toggleKeyMouseEventEnabled() {
-    return keyMouseEventEnabled = !keyMouseEventEnabled;
+    setKeyMouseEventEnabled(!keyMouseEventEnabled);
+    return keyMouseEventEnabled;
 }
 
 bool ofxComponentBase::getKeyMouseEventEnebled() {
     return keyMouseEventEnabled;
 }
 
+void ofxComponentBase::setInputInterest(int mask) {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self, mask] { self->setInputInterest(mask); });
+        return;
+    }
+    inputInterestDeclared = true;
+    if (inputInterest == mask) return;
+    inputInterest = mask;
+    ++inputInterestVersion;
+}
+
+void ofxComponentBase::notInterested(InputEventType type) {
+    if (inputInterestDeclared || !(inputInterest & type)) return;
+    inputInterest &= ~type;
+    ++inputInterestVersion;
+}
+
 ofRectangle ofxComponentBase::getRect() {
     return rect;
 }
@@ -365,6 +786,38 @@ ofRectangle ofxComponentBase::getGlobalRect() {
     }
 }
 
+ofRectangle ofxComponentBase::getGlobalBounds() {
+    return getCachedGlobalBounds();
+}
+
+const ofRectangle& ofxComponentBase::getCachedGlobalBounds() {
+    updateGlobalMatrix();
+    if (boundsGlobalVersion == globalVersion && boundsWidth == rect.width && boundsHeight == rect.height) {
+        return globalBounds;
+    }
+    
+    ofVec2f p = globalMatrix.apply(0, 0);
+    globalBounds.set(p.x, p.y, 0, 0);
+    p = globalMatrix.apply(rect.width, 0);
+    globalBounds.growToInclude(p.x, p.y);
+    p = globalMatrix.apply(0, rect.height);
+    globalBounds.growToInclude(p.x, p.y);
+    p = globalMatrix.apply(rect.width, rect.height);
+    globalBounds.growToInclude(p.x, p.y);
+    
+    boundsGlobalVersion = globalVersion;
+    boundsWidth = rect.width;
+    boundsHeight = rect.height;
+    return globalBounds;
+}
+
+bool ofxComponentBase::isInView() {
+    // edges included, so zero sized components are visible at their position
+    const ofRectangle& bounds = getCachedGlobalBounds();
+    return bounds.getMinX() <= cullRect.getMaxX() && bounds.getMaxX() >= cullRect.getMinX() &&
+        bounds.getMinY() <= cullRect.getMaxY() && bounds.getMaxY() >= cullRect.getMinY();
+}
+
 ofVec2f ofxComponentBase::getPos() {
     return ofVec2f(rect.x, rect.y);
 }
@@ -416,8 +869,8 @@ float ofxComponentBase::getScale() {
 }
 
 float ofxComponentBase::getGlobalScale() {
-    auto scaleVec = globalMatrix.getScale();
-    return scaleVec.x;
+    updateGlobalMatrix();
+    return globalMatrix.getScale();
 }
 
 float ofxComponentBase::getRotation() {
@@ -425,9 +878,8 @@ float ofxComponentBase::getRotation() {
 }
 
 float ofxComponentBase::getGlobalRotation() {
-    auto quaternion = globalMatrix.getRotate();
-    auto rotationVec = quaternion.getEuler();
-    return rotationVec.z;
+    updateGlobalMatrix();
+    return globalMatrix.getRotation();
 }
 
 void ofxComponentBase::setRect(float x, float y, float width, float height) {
@@ -496,43 +948,55 @@ void ofxComponentBase::setRotation(float _rotation) {
 }
 
 ofVec2f ofxComponentBase::globalToLocalPos(ofVec2f _globalPos) {
-    return globalMatrixInverse.preMult(ofVec3f(_globalPos));
+    updateGlobalMatrixInverse();
+    return globalMatrixInverse.apply(_globalPos);
 }
 
 ofVec2f ofxComponentBase::localToGlobalPos(ofVec2f _localPos) {
-    return globalMatrix.preMult(ofVec3f(_localPos));
+    updateGlobalMatrix();
+    return globalMatrix.apply(_localPos);
 }
 
 float ofxComponentBase::getMouseX() {
-    return getMousePos().x;
+    updateLocalMouse();
+    return localMouse.x;
 }
 
 float ofxComponentBase::getMouseY() {
-    return getMousePos().y;
+    updateLocalMouse();
+    return localMouse.y;
 }
 
 ofVec2f ofxComponentBase::getMousePos() {
-    return globalToLocalPos(ofVec2f(ofGetMouseX(), ofGetMouseY()));
+    updateLocalMouse();
+    return localMouse;
 }
 
 ofVec2f ofxComponentBase::getPreviousMousePos() {
-    return globalToLocalPos(ofVec2f(ofGetPreviousMouseX(), ofGetPreviousMouseY()));
+    updateLocalMouse();
+    return localPreviousMouse;
 }
 
 ofMatrix4x4 ofxComponentBase::getLocalMatrix() {
-    return localMatrix;
+    return localMatrix.toMatrix();
 }
 
 ofMatrix4x4 ofxComponentBase::getLocalMatrixInverse() {
-    return localMatrixInverse;
+    if (localInverseDirty) {
+        localMatrixInverse = localMatrix.getInverse();
+        localInverseDirty = false;
+    }
+    return localMatrixInverse.toMatrix();
 }
 
 ofMatrix4x4 ofxComponentBase::getGlobalMatrix() {
-    return globalMatrix;
+    updateGlobalMatrix();
+    return globalMatrix.toMatrix();
 }
 
 ofMatrix4x4 ofxComponentBase::getGlobalMatrixInverse() {
-    return globalMatrixInverse;
+    updateGlobalMatrixInverse();
+    return globalMatrixInverse.toMatrix();
 }
 
 void ofxComponentBase::setMovable(bool _movable) {
@@ -545,12 +1009,22 @@ bool ofxComponentBase::getMovable() {
 }
 
 void ofxComponentBase::setMoving(bool _moving) {
-    if (_moving) movingComponent = shared_from_this();
-    else if (getMoving()) movingComponent = nullptr;
+    if (_moving) {
+        if (movingComponent) movingComponent->moving = false;
+        movingComponent = this;
+        moving = true;
+    }
+    else if (moving) {
+        movingComponent = nullptr;
+        moving = false;
+    }
 }
 
-bool ofxComponentBase::getMoving() {
-    return !needStartExec && movingComponent == shared_from_this();
+void ofxComponentBase::setMouseOverComponent(ofxComponentBase* c) {
+    if (mouseOverComponent == c) return;
+    if (mouseOverComponent) mouseOverComponent->mouseOver = false;
+    mouseOverComponent = c;
+    if (c) c->mouseOver = true;
 }
 
 bool ofxComponentBase::inside(ofVec2f p) {
@@ -562,22 +1036,41 @@ bool ofxComponentBase::inside(float x, float y) {
 }
 
 void ofxComponentBase::setParent(shared_ptr<ofxComponentBase>  _parent) {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self, _parent] { self->setParent(_parent); });
+        return;
+    }
     if (parent == _parent) return;
     
+    // globalActive is updated once below, not in between
     if (parent != nullptr) {
-        parent->removeChild(shared_from_this());
+        parent->eraseChild(this);
     }
     
     parent = _parent;
     
     if (parent != nullptr) {
         parent->addChild(shared_from_this());
+        if (transformStore) transformStore->attach(this);
     }
+    updateGlobalActive();
     
-    updateGlobalMatrix();
+    // globalMatrix of this and children will be recomputed on next read
+    ++localVersion;
+    
+    if (spatialIndex) {
+        spatialIndex->markDirty(this);
+        spatialIndex->markOrderDirty();
+    }
 }
 
 void ofxComponentBase::removeParent() {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self] { self->removeParent(); });
+        return;
+    }
     if (parent != nullptr) {
         auto p = parent;
         parent = nullptr;
@@ -586,11 +1079,21 @@ void ofxComponentBase::removeParent() {
 }
 
 void ofxComponentBase::addChild(shared_ptr<ofxComponentBase>  _child) {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self, _child] { self->addChild(_child); });
+        return;
+    }
     // insert to back
     insertChild(_child, children.size());
 }
 
 void ofxComponentBase::insertChild(shared_ptr<ofxComponentBase>  _child, int index) {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self, _child, index] { self->insertChild(_child, index); });
+        return;
+    }
     int alreadyListedIndex = -1;
     
     int i = 0;
@@ -619,23 +1122,86 @@ void ofxComponentBase::insertChild(shared_ptr<ofxComponentBase>  _child, int ind
         children.insert(children.begin(), _child);
     }
     
+    ++structureVersion;
+    invalidateCache();
+    
     if (alreadyListedIndex == -1) {
         _child->setParent(shared_from_this());
+        _child->requestUpdate();
+    }
+    else if (spatialIndex) {
+        spatialIndex->markOrderDirty();
     }
 }
 
 void ofxComponentBase::removeChild(shared_ptr<ofxComponentBase>  _child) {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self, _child] { self->removeChild(_child); });
+        return;
+    }
+    if (eraseChild(_child.get())) _child->updateGlobalActive();
+}
+
+bool ofxComponentBase::eraseChild(ofxComponentBase* _child) {
     for (int i = 0; i < children.size(); ++i) {
-        auto c = children[i];
-        if (c == _child) {
+        if (children[i].get() == _child) {
+            // keeps _child alive until the end
+            auto c = children[i];
             _child->parent = nullptr;
             children.erase(children.begin() + i);
-            break;
+            ++structureVersion;
+            invalidateCache();
+            if (spatialIndex) spatialIndex->removeSubtree(_child);
+            if (transformStore) transformStore->detach(_child);
+            return true;
         }
     }
+    return false;
+}
+
+void ofxComponentBase::removeAllChildren() {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self] { self->removeAllChildren(); });
+        return;
+    }
+    if (children.empty()) return;
+    auto removed = std::move(children);
+    children.clear();
+    for (auto& c : removed) {
+        c->parent = nullptr;
+        if (spatialIndex) spatialIndex->removeSubtree(c.get());
+        if (transformStore) transformStore->detach(c.get());
+    }
+    ++structureVersion;
+    invalidateCache();
+    for (auto& c : removed) {
+        c->updateGlobalActive();
+    }
+}
+
+void ofxComponentBase::removeDestroyedChildren() {
+    // destroyed, so their globalActive doesn't matter anymore
+    auto itr = remove_if(children.begin(), children.end(), [](const shared_ptr<ofxComponentBase>& c) {
+        if (!c->isDestroyed()) return false;
+        c->parent = nullptr;
+        if (spatialIndex) spatialIndex->removeSubtree(c.get());
+        if (transformStore) transformStore->detach(c.get());
+        return true;
+    });
+    if (itr == children.end()) return;
+    children.erase(itr, children.end());
+    ++structureVersion;
+    invalidateCache();
 }
 
 void ofxComponentBase::swapChild(int indexA, int indexB) {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self, indexA, indexB] { self->swapChild(indexA, indexB); });
+        return;
+    }
     if (indexA < 0 || indexB < 0 || indexA >= children.size() || indexB >= children.size()) {
         ofLogWarning() << "swapChild(): invalid index " << indexA << " and " << indexB;
         return;
@@ -646,10 +1212,66 @@ void ofxComponentBase::swapChild(int indexA, int indexB) {
     auto A = children[indexA];
     children[indexA] = children[indexB];
     children[indexB] = A;
+    ++structureVersion;
+    invalidateCache();
+    
+    if (spatialIndex) spatialIndex->markOrderDirty();
 }
 
 void ofxComponentBase::setConstrain(bool _constrain) {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self, _constrain] { self->setConstrain(_constrain); });
+        return;
+    }
+    if (constrain == _constrain) return;
     constrain = _constrain;
+    ++drawVersion;
+}
+
+void ofxComponentBase::setCacheAsBitmap(bool cache) {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self, cache] { self->setCacheAsBitmap(cache); });
+        return;
+    }
+    if (cacheAsBitmap == cache) return;
+    cacheAsBitmap = cache;
+    cacheValid = false;
+    if (cache) ++numCaching;
+    else --numCaching;
+    ++drawVersion;
+}
+
+void ofxComponentBase::invalidateCache() {
+    if (numCaching == 0) return;
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self] { self->invalidateCache(); });
+        return;
+    }
+    for (auto c = this; c; c = c->parent.get()) {
+        c->cacheValid = false;
+    }
+}
+
+void ofxComponentBase::setChildrenDrawOutside(bool outside) {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self, outside] { self->setChildrenDrawOutside(outside); });
+        return;
+    }
+    if (childrenDrawOutside == outside) return;
+    childrenDrawOutside = outside;
+    ++drawVersion;
+}
+
+void ofxComponentBase::setConstrainMode(ConstrainMode mode) {
+    constrainMode = mode;
+}
+
+ConstrainMode ofxComponentBase::getConstrainMode() {
+    return constrainMode;
 }
 
 bool ofxComponentBase::getConstrain() {
@@ -657,9 +1279,17 @@ bool ofxComponentBase::getConstrain() {
 }
 
 void ofxComponentBase::destroy() {
+    if (isInParallelUpdate()) {
+        auto self = shared_from_this();
+        parallelUpdater->defer([self] { self->destroy(); });
+        return;
+    }
     if (destroyed) return;
     
     destroyed = true;
+    ++inputVersion;
+    ++drawVersion;
+    if (parent) parent->invalidateCache();
     setMoving(false);
     
     if (!needStartExec) {
@@ -682,6 +1312,14 @@ bool ofxComponentBase::isDestroyed() {
     return destroyed;
 }
 
+ofxComponentBase* ofxComponentBase::getComponent(ComponentHandle handle) {
+    return allComponents.get(handle);
+}
+
+const vector<const vector<ofxComponentBase*>*>& ofxComponentBase::findTypeLists(const ofxComponentTypeInfo& type, bool includeSubclasses) {
+    return allComponents.getTypeLists(type, includeSubclasses);
+}
+
 shared_ptr<ofxComponentBase>  ofxComponentBase::getChild(int i) {
     if (i < 0 || children.size() <= i) {
         return nullptr;
@@ -690,51 +1328,111 @@ shared_ptr<ofxComponentBase>  ofxComponentBase::getChild(int i) {
 }
 
 void ofxComponentBase::updateMatrix() {
-    /*
-     localMatrix.translate(ofVec3f(rect.x - rect.width / 2, rect.y - rect.height / 2, 0));
-     localMatrix.rotateRad(rotation * DEG_TO_RAD, 0, 0, 1);
-     localMatrix.translate(ofVec3f(rect.width / 2, rect.height / 2, 0));
-     localMatrix.scale(ofVec3f(scale, scale, scale));
-     */
-    
     // make local
-    localMatrix = ofMatrix4x4();
-    if (scaleAlignment == Center) localMatrix.translate(ofVec3f(-rect.width / 2, -rect.height / 2, 0));
-    localMatrix.rotateRad(rotation * DEG_TO_RAD, 0, 0, 1);
-    localMatrix.scale(ofVec3f(scale, scale, scale));
-    localMatrix.translate(ofVec3f(rect.x, rect.y, 0));
-    if (scaleAlignment == Center) localMatrix.translate(ofVec3f(rect.width / 2, rect.height / 2, 0));
+    // Same as translate(-center), rotate, scale, translate(pos + center),
+    // written out for 2x3 affine.
+    float rad = rotation * DEG_TO_RAD;
+    float cosR = cosf(rad) * scale;
+    float sinR = sinf(rad) * scale;
+    float cx = 0, cy = 0;
+    if (scaleAlignment == Center) {
+        cx = rect.width / 2;
+        cy = rect.height / 2;
+    }
+    localMatrix = ofxComponentAffine2D(
+        cosR, sinR,
+        -sinR, cosR,
+        -cx * cosR + cy * sinR + rect.x + cx,
+        -cx * sinR - cy * cosR + rect.y + cy);
     
-    localMatrixInverse = localMatrix.getInverse();
+    localInverseDirty = true;
+    ++localVersion;
+    if (!isInParallelUpdate()) {
+        transformChanged();
+    }
+    else if (!transformChangePending) {
+        // the store and the index are shared, tell them after the parallel phase
+        transformChangePending = true;
+        parallelUpdater->deferTransformChanged(this);
+    }
     
     onLocalMatrixChanged();
-    updateGlobalMatrix();
-    ofNotifyEvent(localMatrixChangedEvents);
+    localMatrixChangedEvents.notify();
+}
+
+void ofxComponentBase::transformChanged() {
+    transformChangePending = false;
+    if (transformStore && transformIndex >= 0) transformStore->setLocal(transformIndex, localMatrix);
+    if (spatialIndex) spatialIndex->markDirty(this);
+    if (parent) parent->invalidateCache();
+    requestUpdate();
 }
 
 void ofxComponentBase::updateGlobalMatrix() {
+    if (transformStore && transformIndex >= 0) {
+        // computed in batch by the store, may drop this from the store if the tree changed
+        transformStore->update();
+        if (transformIndex >= 0) {
+            unsigned int version = transformStore->getGlobalVersion(transformIndex);
+            if (globalVersion != version) {
+                globalMatrix = transformStore->getGlobal(transformIndex);
+                globalVersion = version;
+                globalInverseDirty = true;
+            }
+            return;
+        }
+    }
+    
+    // make sure parents are up to date first
+    unsigned int parentVersion = 0;
+    if (parent != nullptr) {
+        parent->updateGlobalMatrix();
+        parentVersion = parent->globalVersion;
+    }
+    
+    // nothing changed in this level and above
+    if (globalLocalVersion == localVersion && globalParentVersion == parentVersion) return;
+    
     // make global
     if (parent == nullptr) {
         globalMatrix = localMatrix;
     }
     else {
-        globalMatrix = localMatrix * parent->getGlobalMatrix();
+        globalMatrix = localMatrix * parent->globalMatrix;
     }
     
-    globalMatrixInverse = globalMatrix.getInverse();
-    
-    for (auto& c : children) {
-        c->updateGlobalMatrix();
+    globalLocalVersion = localVersion;
+    globalParentVersion = parentVersion;
+    ++globalVersion;
+    globalInverseDirty = true;
+}
+
+void ofxComponentBase::updateGlobalMatrixInverse() {
+    updateGlobalMatrix();
+    if (globalInverseDirty) {
+        globalMatrixInverse = globalMatrix.getInverse();
+        globalInverseDirty = false;
     }
 }
 
+void ofxComponentBase::updateLocalMouse() {
+    updateGlobalMatrix();
+    // same mouse and no transform change in this level and above
+    if (localMouseVersion == mouseVersion && localMouseGlobalVersion == globalVersion) return;
+    
+    updateGlobalMatrixInverse();
+    localMouse = globalMatrixInverse.apply(ofVec2f(ofGetMouseX(), ofGetMouseY()));
+    localPreviousMouse = globalMatrixInverse.apply(ofVec2f(ofGetPreviousMouseX(), ofGetPreviousMouseY()));
+    localMouseVersion = mouseVersion;
+    localMouseGlobalVersion = globalVersion;
+}
+
 // ========================================================
 // Timer
 // ========================================================
 
-ofxComponentBase::Timer::Timer(TimerFunc func, float wait)
-: function(func)
-{
+ofxComponentBase::Timer::Timer(TimerFunc func, float wait) {
+    function.assign(func);
     execTime = ofGetElapsedTimef() + wait;
 }
 
@@ -742,14 +1440,20 @@ bool ofxComponentBase::Timer::run() {
     if (done) return false;
     // 1回だけ実行
     if (function) {
+        running = true;
         function();
+        running = false;
     }
     done = true;
+    // captures are freed now, not when the slot is recycled
+    function.reset();
     return true;
 }
 
 void ofxComponentBase::Timer::cancel() {
     done = true;
+    // canceled from its own callback, run() releases it
+    if (!running) function.reset();
 }
 
 // get done (executed or canceled)
@@ -763,6 +1467,13 @@ float ofxComponentBase::Timer::getExecTime() {
 
 void ofxComponentBase::Timer::shiftExecTime(const float sec) {
     execTime += sec;
+    reschedule();
+}
+
+void ofxComponentBase::Timer::reschedule() {
+    // paused timers are scheduled again on resume
+    if (done || paused || owner == nullptr) return;
+    timerScheduler.schedule(this);
 }
 
 bool ofxComponentBase::Timer::checkElapsed(float now) {
@@ -795,11 +1506,11 @@ void ofxComponentBase::setTimerPaused(bool paused) {
     timerPaused = paused;
     
     // Apply to all timers
-    for (auto& timer : timerFunctions) {
-        timer->setPaused(paused);
-    }
-    for (auto& timer : timerFunctionsToAdd) {
-        timer->setPaused(paused);
+    if (cold) {
+        for (auto& h : cold->timerFunctions) {
+            Timer* timer = timerScheduler.get(h);
+            if (timer) timer->setPaused(paused);
+        }
     }
     
     // Propagate to children
@@ -807,3 +1518,43 @@ void ofxComponentBase::setTimerPaused(bool paused) {
         child->setTimerPaused(paused);
     }
 }
+
+// ========================================================
+// TimerRef
+// ========================================================
+
+// recycled handles behave as a finished timer
+
+void ofxComponentBase::TimerRef::cancel() const {
+    Timer* t = timerScheduler.get(handle);
+    if (t) t->cancel();
+}
+
+bool ofxComponentBase::TimerRef::isDone() const {
+    Timer* t = timerScheduler.get(handle);
+    return t == nullptr || t->isDone();
+}
+
+bool ofxComponentBase::TimerRef::isPaused() const {
+    Timer* t = timerScheduler.get(handle);
+    return t && t->isPaused();
+}
+
+void ofxComponentBase::TimerRef::setPaused(bool paused) const {
+    Timer* t = timerScheduler.get(handle);
+    if (t) t->setPaused(paused);
+}
+
+float ofxComponentBase::TimerRef::getExecTime() const {
+    Timer* t = timerScheduler.get(handle);
+    return t ? t->getExecTime() : 0.0f;
+}
+
+void ofxComponentBase::TimerRef::shiftExecTime(const float sec) const {
+    Timer* t = timerScheduler.get(handle);
+    if (t) t->shiftExecTime(sec);
+}
+
+bool ofxComponentBase::TimerRef::isAlive() const {
+    return timerScheduler.get(handle) != nullptr;
+}
@@ -1,5 +1,9 @@
 #pragma once
 #include "ofMain.h"
+#include "ofxComponentAffine2D.h"
+#include "ofxComponentSmallFunction.h"
+#include "ofxComponentLazyEvent.h"
+#include "ofxComponentType.h"
 
 #ifndef TAU
 #define TAU 6.28318530717958647693
@@ -9,16 +13,73 @@
 #endif
 
 namespace ofxComponent {
+	class ofxComponentSpatialIndex;
+	class ofxComponentTransformStore;
+	class ofxComponentTimerScheduler;
+	class ofxComponentRegistry;
+	class ofxComponentInputRouter;
+	class ofxComponentParallelUpdater;
+	class ofxComponentRenderList;
+	class ofxComponentFboPool;
+
 	enum Alignment {
 		Cornar,
 		Center
 	};
 
+	// how setConstrain() clips
+	enum ConstrainMode {
+		ConstrainFbo,    // draw the children in an fbo of the rect size
+		ConstrainScissor // scissor test, no extra render target. Falls back to fbo when rotated or skewed on screen
+	};
+
+	// input events, bits of an interest mask
+	enum InputEventType {
+		InputKeyPressed = 1 << 0,
+		InputKeyReleased = 1 << 1,
+		InputMouseMoved = 1 << 2,
+		InputMousePressed = 1 << 3,
+		InputMouseDragged = 1 << 4,
+		InputMouseReleased = 1 << 5,
+		InputMouseScrolled = 1 << 6,
+		InputDragEvent = 1 << 7,
+		InputAll = (1 << 8) - 1
+	};
+
 	class ofxComponentBase : public enable_shared_from_this<ofxComponentBase> {
+		friend class ofxComponentTransformStore;
+		friend class ofxComponentTimerScheduler;
+		friend class ofxComponentManager;
+		friend class ofxComponentInputRouter;
+		friend class ofxComponentParallelUpdater;
+		friend class ofxComponentRenderList;
+		friend class ofxComponentSpatialIndex;
 	public:
 		ofxComponentBase();
 		~ofxComponentBase();
 
+		// class identity, see OFX_COMPONENT_TYPE()
+		typedef ofxComponentBase ofxComponentSelfType;
+		static const ofxComponentTypeInfo& staticType();
+		virtual const ofxComponentTypeInfo& getType() const { return staticType(); }
+
+		// true if this is a T or derived from it. Constant time, works without RTTI.
+		// T needs OFX_COMPONENT_TYPE().
+		template<typename T>
+		bool is() const {
+			static_assert(isRegisteredType<T>(), "T needs OFX_COMPONENT_TYPE()");
+			return getType().isA(T::staticType());
+		}
+		// this as a T, nullptr if it is not one. No refcount change
+		template<typename T>
+		T* as() {
+			return is<T>() ? static_cast<T*>(this) : nullptr;
+		}
+		template<typename T>
+		const T* as() const {
+			return is<T>() ? static_cast<const T*>(this) : nullptr;
+		}
+
 		// of events
 		void setup();
 		virtual void onSetup() {}
@@ -27,9 +88,41 @@ namespace ofxComponent {
 		virtual void onUpdate() {}
 		virtual void postUpdate() {}
 
+		// How often onUpdate()/postUpdate() of this component are called. Children have their own policy.
+		// Timers run every frame regardless.
+		void setUpdateEveryFrame();
+		void setUpdateEveryNFrames(int n);
+		void setUpdateRate(float hz);
+
+		// A sleeping component and its whole subtree are skipped by update().
+		// Only components that call requestUpdate() get one update, then they sleep again.
+		// That is done for you when a timer elapses, the transform or size changes,
+		// a child is added, it is activated or the mouse is pressed/released on it.
+		void sleep();
+		void wake();
+		bool isSleeping() { return sleeping; }
+		// one update in the next frame even inside a sleeping subtree
+		void requestUpdate();
+
+		// onUpdate() of this subtree doesn't touch anything outside of it,
+		// so it may run on a worker thread when the manager's parallel update is enabled.
+		// It may change its own subtree's properties. Adding/removing components, destroy(),
+		// setActive(), addTimerFunction(), sleep()/wake(), requestUpdate(), invalidateCache() and
+		// setters of the draw and input flags are applied after all parallel onUpdate() are done.
+		// postUpdate() always runs on the main thread.
+		void setThreadSafeUpdate(bool threadSafe);
+		bool getThreadSafeUpdate() { return threadSafeUpdate; }
+		// the current thread is running onUpdate() of the parallel phase
+		static bool isInParallelUpdate();
+
 		void draw(ofEventArgs&);
-		virtual void onDraw() {}
-		virtual void postDraw() {}
+		virtual void onDraw() { notDrawing(false); }
+		virtual void postDraw() { notDrawing(true); }
+
+		// Whether onDraw()/postDraw() draw anything, used by the manager's retained draw.
+		// Detected by default: the empty ofxComponentBase ones report it on their first call.
+		// Declare it if an override calls them. Declaring stops the detection.
+		void setDrawInterest(bool onDraw, bool postDraw);
 
 		void exit(ofEventArgs&);
 		virtual void onExit() {}
@@ -46,35 +139,35 @@ namespace ofxComponent {
 		bool getActive() { return isActive; }
 		virtual void onActiveChanged(bool active) { ; }
 
-		// global active
-		bool getGlobalActive();
+		// global active, this and all parents are active
+		bool getGlobalActive() const { return globalActive; }
 		virtual void onGlobalActiveChanged(bool active) { ; }
 
 		// key
 		void keyPressed(ofKeyEventArgs&);
-		virtual void onKeyPressed(ofKeyEventArgs&) {}
+		virtual void onKeyPressed(ofKeyEventArgs&) { notInterested(InputKeyPressed); }
 
 		void keyReleased(ofKeyEventArgs&);
-		virtual void onKeyReleased(ofKeyEventArgs&) {}
+		virtual void onKeyReleased(ofKeyEventArgs&) { notInterested(InputKeyReleased); }
 
 		// mouse
 		void mouseMoved(ofMouseEventArgs&);
-		virtual void onMouseMoved(ofMouseEventArgs&) {}
+		virtual void onMouseMoved(ofMouseEventArgs&) { notInterested(InputMouseMoved); }
 
 		void mousePressed(ofMouseEventArgs&);
-		virtual void onMousePressed(ofMouseEventArgs&) {}
+		virtual void onMousePressed(ofMouseEventArgs&) { notInterested(InputMousePressed); }
 
 		void mouseDragged(ofMouseEventArgs&);
-		virtual void onMouseDragged(ofMouseEventArgs&) {}
+		virtual void onMouseDragged(ofMouseEventArgs&) { notInterested(InputMouseDragged); }
 
 		void mouseReleased(ofMouseEventArgs&);
-		virtual void onMouseReleased(ofMouseEventArgs&) {}
+		virtual void onMouseReleased(ofMouseEventArgs&) { notInterested(InputMouseReleased); }
 
 		void mouseScrolled(ofMouseEventArgs&);
-		virtual void onMouseScrolled(ofMouseEventArgs&) {};
+		virtual void onMouseScrolled(ofMouseEventArgs&) { notInterested(InputMouseScrolled); }
         
 		void dragEvent(ofDragInfo&);
-		virtual void onDragEvent(ofDragInfo&) {}
+		virtual void onDragEvent(ofDragInfo&) { notInterested(InputDragEvent); }
 
         // This method is called when the mouse is pressed down while over the topmost visible component, even if multiple components are overlapping.
         // It handles the actions or events that should occur in response to the mouse press on that topmost component.
@@ -90,25 +183,34 @@ namespace ofxComponent {
         // When implementing UI elements such as buttons, if multiple buttons overlap, using isMouseInside() alone may cause multiple objects to respond.
         // To prevent this, by also checking whether the object is on the top layer, simultaneous pressing of overlapping buttons can be avoided.
         // In addition, when implementing buttons, another option is to register events with mousePressedTopEvents.
-        bool isMouseOver();
+        bool isMouseOver() const { return mouseOver; }
         
         // This method returns true while the mouse is clicked and held over the component.
         // It continues to return true even if the mouse is dragged outside of the component.
         // This behavior is useful for recognizing mouse movements when dragging a component, even when outside of its bounds.
-        bool isMousePressedOverComponent();
+        bool isMousePressedOverComponent() const { return mousePressedOverComponent; }
 
         // key and mouse enabled
 		void setKeyMouseEventEnabled(bool enabled);
 		bool toggleKeyMouseEventEnabled();
 		bool getKeyMouseEventEnebled();
 
+		// Input events this component handles (InputEventType bits), used when the manager routes input.
+		// Detected by default: an on* handler that is not overridden reports it on its first call,
+		// and the component is skipped for that event afterwards.
+		// Declare it if an override calls the empty ofxComponentBase handler. Declaring stops the detection.
+		void setInputInterest(int mask);
+		int getInputInterest() { return inputInterest; }
+
 		// On change position, size, scale, etc
 		virtual void onLocalMatrixChanged() {};
-		// Notify to others when localMatrixChanged.
-		ofEvent<void> localMatrixChangedEvents;
+		// Notify to others when localMatrixChanged. The ofEvent is created with the first listener.
+		ofxComponentLazyEvent localMatrixChangedEvents;
 
 		ofRectangle getRect();
 		ofRectangle getGlobalRect();
+		// Axis aligned bounding box of the rect in global coordinates (rotation and scale applied)
+		ofRectangle getGlobalBounds();
 		ofVec2f getPos();
 		ofVec2f getCenterPos();
 		ofVec2f getGlobalPos();
@@ -154,7 +256,7 @@ namespace ofxComponent {
 		void setMovable(bool _movable);
 		bool getMovable();
 		void setMoving(bool _moving);
-		bool getMoving();
+		bool getMoving() const { return moving && !needStartExec; }
 		bool inside(ofVec2f p);
 		bool inside(float x, float y);
         
@@ -164,6 +266,7 @@ namespace ofxComponent {
 		void addChild(shared_ptr<ofxComponentBase> _child);
 		void insertChild(shared_ptr<ofxComponentBase> _child, int index);
 		void removeChild(shared_ptr<ofxComponentBase> _child);
+		void removeAllChildren();
         void swapChild(int indexA, int indexB);
 
         // Set constrain to true when you want to draw child components only within the size defined by the rect of the parent component.
@@ -172,24 +275,86 @@ namespace ofxComponent {
         // onMousePressed() collider will also be constrained within the bounds of the parent component.
 		void setConstrain(bool _constrain);
 		bool getConstrain();
+		// Both modes clip to the rect, so hit testing is the same for both.
+		// Nested scissors are intersected. The fbo mode is the default because it can be rotated.
+		void setConstrainMode(ConstrainMode mode);
+		ConstrainMode getConstrainMode();
+
+		// Draw this subtree into a texture once and draw only the texture until it changes.
+		// Like constrain, only the rect is drawn. Moving this component keeps the cache.
+		// Adding/removing/(de)activating components or moving them inside the subtree invalidates it.
+		// Call invalidateCache() when something else changes what is drawn (text, colors, animation).
+		void setCacheAsBitmap(bool cache);
+		bool getCacheAsBitmap() { return cacheAsBitmap; }
+		// redraw the cache of this and all cached parents on the next draw
+		void invalidateCache();
+
+		// With culling enabled in the manager, the whole subtree is skipped when the rect is out of view.
+		// Set true when children may draw outside the rect, then only onDraw()/postDraw() of this are skipped.
+		void setChildrenDrawOutside(bool outside);
+		bool getChildrenDrawOutside() { return childrenDrawOutside; }
 
 		// remove this
 		void destroy();
 		void destroy(float delaySec); // delay destroy [sec]
 		bool isDestroyed();
 
+		// Non-owning view of the children. Iterating it does not copy the list
+		// nor touch refcounts, and yields ofxComponentBase*.
+		// Like a vector iterator, it is invalidated when children of this component
+		// are added, removed or reordered. Use getChildren() when you need to change the tree while iterating.
+		class ChildrenView {
+		public:
+			typedef vector<shared_ptr<ofxComponentBase> > List;
+
+			class iterator {
+			public:
+				iterator(List::const_iterator _itr) : itr(_itr) {}
+				ofxComponentBase* operator*() const { return itr->get(); }
+				iterator& operator++() { ++itr; return *this; }
+				bool operator==(const iterator& other) const { return itr == other.itr; }
+				bool operator!=(const iterator& other) const { return itr != other.itr; }
+			private:
+				List::const_iterator itr;
+			};
+
+			ChildrenView(const List& _list) : list(&_list) {}
+			iterator begin() const { return iterator(list->begin()); }
+			iterator end() const { return iterator(list->end()); }
+			size_t size() const { return list->size(); }
+			bool empty() const { return list->empty(); }
+			ofxComponentBase* operator[](size_t i) const { return (*list)[i].get(); }
+
+		private:
+			const List* list;
+		};
+
 		// component getter
 		shared_ptr<ofxComponentBase> getParent() { return parent; }
+		// returns a copy, safe to use while changing the tree
 		vector<shared_ptr<ofxComponentBase>> getChildren() { return children; }
+		ChildrenView getChildrenView() const { return ChildrenView(children); }
 		shared_ptr<ofxComponentBase> getChild(int i);
+
+		// Visit all descendants (not this) in draw order, without allocation.
+		// visitor is bool(ofxComponentBase&), return false to skip the children of that component.
+		// The visitor must not add, remove or reorder components.
+		// If it does, the walk stops right after that visitor call and returns false,
+		// so it never touches a stale pointer. Returns true when the whole tree was visited.
+		template<typename F>
+		bool walkDescendants(F&& visitor) {
+			return walkDescendants(visitor, structureVersion);
+		}
         
         // get shared_ptr
         shared_ptr<ofxComponentBase> getThis() {
             return shared_from_this();
         }
+        // nullptr without touching the refcount if this is not a T
         template<typename T>
         inline shared_ptr<T> getThisAs() {
-            return dynamic_pointer_cast<T>(shared_from_this());
+            T* p = castTo<T>(this);
+            return p ? shared_ptr<T>(shared_from_this(), p) : nullptr;
         }
 		// get weak_ptr
 		weak_ptr<ofxComponentBase> getWeak() {
@@ -197,46 +362,228 @@ namespace ofxComponent {
 		}
 		template<typename T>
 		inline std::weak_ptr<T> getWeakAs() {
-			return std::weak_ptr<T>(dynamic_pointer_cast<T>(shared_from_this()));
+			return std::weak_ptr<T>(getThisAs<T>());
 		}
 
+        // Stable id of a component, from start() until it is removed after destroy().
+        // Keep this instead of a pointer when you must not extend the lifetime.
+        struct ComponentHandle {
+            uint32_t index = 0;
+            uint32_t generation = 0; // 0 is never valid
+            bool operator==(const ComponentHandle& other) const { return index == other.index && generation == other.generation; }
+            bool operator!=(const ComponentHandle& other) const { return !(*this == other); }
+        };
+        ComponentHandle getHandle() const { return handle; }
+        // nullptr once the component has been removed, no refcount change
+        static ofxComponentBase* getComponent(ComponentHandle handle);
+        template<typename T>
+        static T* getComponentAs(ComponentHandle handle) {
+            return castTo<T>(getComponent(handle));
+        }
+
+        // All started components of class T that are not destroyed, in no particular order.
+        // With includeSubclasses, components of classes derived from T too.
+        // Components are listed per class, so this costs the size of the result, not of the tree.
+        // T needs OFX_COMPONENT_TYPE(), classes without it are listed with their closest registered base.
+        template<typename T>
+        static void findAll(vector<T*>& result, bool includeSubclasses = true) {
+            static_assert(isRegisteredType<T>(), "T needs OFX_COMPONENT_TYPE()");
+            result.clear();
+            for (auto list : findTypeLists(T::staticType(), includeSubclasses)) {
+                for (auto c : *list) {
+                    if (!c->destroyed) result.push_back(static_cast<T*>(c));
+                }
+            }
+        }
+        template<typename T>
+        static vector<T*> findAll(bool includeSubclasses = true) {
+            vector<T*> result;
+            findAll(result, includeSubclasses);
+            return result;
+        }
+
         // This is triggered when a button is pressed and the button is located at the top layer at that coordinate.
         // In this case, use ofAddListener() and provide the instance of this class's mousePressedTopEvents as the first argument.
-        ofEvent<void> mousePressedOverComponentEvents;
+        // The ofEvent is created with the first listener.
+        ofxComponentLazyEvent mousePressedOverComponentEvents;
+
+        // Estimated memory of components in bytes.
+        // Members of subclasses are not known, only ofxComponentBase and what it allocates.
+        struct MemoryUsage {
+            size_t components = 0;
+            size_t base = 0;     // sizeof(ofxComponentBase)
+            size_t children = 0; // child lists
+            size_t cold = 0;     // timers and events, only when used
+            size_t fbo = 0;      // own constrain/cache render targets with their pixels, only when used
+            size_t total() const { return base + children + cold + fbo; }
+        };
+        // this component only
+        MemoryUsage getMemoryUsage() const;
+        // this and all descendants
+        MemoryUsage getSubtreeMemoryUsage();
 
 		void setTimerPaused(bool paused);
 		bool isTimerPaused() const { return timerPaused; }
 
 	private:
 		bool isActive = true;
+		// isActive of this and all parents, kept up to date by setActive() and parent changes
+		bool globalActive = true;
 		bool keyMouseEventEnabled = true;
+		bool drawsOnDraw = true;
+		bool drawsPostDraw = true;
+		bool drawInterestDeclared = false;
+		void notDrawing(bool post);
+		// drawn in this frame of ofxComponentRenderList
+		unsigned int drawStamp = 0, postDrawStamp = 0;
+		enum UpdatePolicy {
+			UpdateEveryFrame,
+			UpdateEveryNFrames,
+			UpdateFixedRate
+		};
+		UpdatePolicy updatePolicy = UpdateEveryFrame;
+		int updateInterval = 1;     // frames, UpdateEveryNFrames
+		float updatePeriod = 0;     // sec, UpdateFixedRate
+		float nextUpdateTime = 0;
+		uint64_t updatePhase = 0;   // spreads components of the same interval over frames
+		bool sleeping = false;
+		bool updateRequested = false;      // requestUpdate() on this
+		bool childUpdateRequested = false; // requestUpdate() somewhere below
+		bool isUpdateDue();
+		void updateRequestedOnly(ofEventArgs& args);
+		bool threadSafeUpdate = false;
+		// onUpdate() done in the parallel phase with this stamp
+		unsigned int parallelUpdatedStamp = 0;
+		bool parallelDue = false;
+		void updateParallel(ofxComponentParallelUpdater& updater);
+		bool transformChangePending = false;
+		// tell the transform store, spatial index, sleeping parents
+		void transformChanged();
+		int inputInterest = InputAll;
+		bool inputInterestDeclared = false;
+		void notInterested(InputEventType type);
+		// used by ofxComponentInputRouter
+		unsigned int inputOrder = 0, inputBuildStamp = 0, inputDispatchStamp = 0;
+		// event handling of this component only, without children
+		void handleMousePressed(ofMouseEventArgs& mouse);
+		void handleMouseDragged(ofMouseEventArgs& mouse);
+		void handleMouseReleased(ofMouseEventArgs& mouse);
 		ofRectangle rect;
 		float scale = 1.0;
 		Alignment scaleAlignment = Center;
 		float rotation = 0;
-		ofMatrix4x4 localMatrix, localMatrixInverse, globalMatrix, globalMatrixInverse;
+		// 2D only, converted to ofMatrix4x4 in the getters for compatibility
+		ofxComponentAffine2D localMatrix, localMatrixInverse, globalMatrix, globalMatrixInverse;
+		// Global matrices are lazy. Changes only bump localVersion,
+		// and updateGlobalMatrix() recomputes the stale levels when someone reads them.
+		unsigned int localVersion = 1;       // bumped when localMatrix or parent changes
+		unsigned int globalVersion = 0;      // bumped when globalMatrix is recomputed
+		unsigned int globalLocalVersion = 0; // localVersion used for current globalMatrix
+		unsigned int globalParentVersion = 0;// parent's globalVersion used for current globalMatrix
+		bool localInverseDirty = false;
+		bool globalInverseDirty = true;
+		// index in transformStore, -1 if not stored there
+		int transformIndex = -1;
 		void updateMatrix();
 		void updateGlobalMatrix();
+		void updateGlobalMatrixInverse();
 		void globalActiveChanged(bool _globalActive);
+		// recompute globalActive from the parent, set and notify the subtree if it changed
+		void updateGlobalActive();
+		void setGlobalActiveFlag(bool _globalActive);
+		// removeChild() without updating globalActive of the child, for reparenting
+		bool eraseChild(ofxComponentBase* _child);
+
+		// getMousePos() and getPreviousMousePos(), computed once per mouseVersion and globalVersion
+		ofVec2f localMouse, localPreviousMouse;
+		unsigned int localMouseVersion = 0;
+		unsigned int localMouseGlobalVersion = 0;
+		void updateLocalMouse();
 
 		// constrain draw in the rect
 		bool constrain = false;
-		ofFbo constrainFbo;
+		ConstrainMode constrainMode = ConstrainFbo;
+		// also the cache of cacheAsBitmap. Allocated on first use, freed when drawn without it
+		unique_ptr<ofFbo> constrainFbo;
+		bool cacheAsBitmap = false;
+		bool cacheValid = false;
+
+		// culling
+		bool childrenDrawOutside = false;
+		// getGlobalBounds() of globalVersion and size, recomputed when one changes
+		ofRectangle globalBounds;
+		unsigned int boundsGlobalVersion = 0;
+		float boundsWidth = -1, boundsHeight = -1;
+		const ofRectangle& getCachedGlobalBounds();
+		// global bounds overlap the current cull rect
+		bool isInView();
 
 		bool needStartExec = true;
+		ComponentHandle handle;
 		bool movable = false;
         bool mousePressedOverComponent = false;
 		bool destroyed = false;
-		static shared_ptr<ofxComponentBase> movingComponent;
+		// Hover, drag and press state. The statics don't own the component,
+		// they are cleared by its destructor. The flags mirror them for cheap queries.
+		bool mouseOver = false;
+		bool moving = false;
+		static ofxComponentBase* movingComponent;
+		// got mousePressedOverComponent, until mouse released
+		static ofxComponentBase* pressedOverComponent;
+		static void setMouseOverComponent(ofxComponentBase* c);
 
 		shared_ptr<ofxComponentBase> parent = nullptr;
 		vector<shared_ptr<ofxComponentBase>> children;
+		// one pass for any number of destroyed children
+		void removeDestroyedChildren();
+
+		// per class lists of allComponents for findAll()
+		static const vector<const vector<ofxComponentBase*>*>& findTypeLists(const ofxComponentTypeInfo& type, bool includeSubclasses);
+
+		// T declares OFX_COMPONENT_TYPE() itself, not only a base of it
+		template<typename T>
+		static constexpr bool isRegisteredType() {
+			static_assert(is_base_of<ofxComponentBase, T>::value, "T must derive from ofxComponentBase");
+			return is_same<typename T::ofxComponentSelfType, T>::value;
+		}
+		// is<T>() for registered classes, dynamic_cast for the others when there is RTTI
+		template<typename T>
+		static T* castTo(ofxComponentBase* c) {
+			if (!c) return nullptr;
+			if constexpr (isRegisteredType<T>()) {
+				return c->as<T>();
+			}
+			else {
+#ifdef OFX_COMPONENT_RTTI
+				return dynamic_cast<T*>(c);
+#else
+				static_assert(isRegisteredType<T>(), "T needs OFX_COMPONENT_TYPE() without RTTI");
+				return nullptr;
+#endif
+			}
+		}
+
+		template<typename F>
+		bool walkDescendants(F& visitor, unsigned int version) {
+			for (size_t i = 0; i < children.size(); ++i) {
+				auto c = children[i].get();
+				bool enter = visitor(*c);
+				if (structureVersion != version) return false;
+				if (enter && !c->walkDescendants(visitor, version)) return false;
+			}
+			return true;
+		}
 
     public:
         typedef function<void()> TimerFunc;
 
+        // Timers live in a pool of timerScheduler and are reused.
+        // The callback is stored inline (small lambdas don't allocate).
         class Timer {
+            friend class ofxComponentBase;
+            friend class ofxComponentTimerScheduler;
         public:
+            Timer() {}
             Timer(TimerFunc func, float wait);
 
             // Define only cancel and isDone,
@@ -255,27 +602,127 @@ namespace ofxComponent {
             bool isPaused() const { return paused; }
 
         private:
-            TimerFunc function;
+            ofxComponentSmallFunction<48> function;
             float execTime = 0.0f;
             bool done = false;      // done: canceled or executed
+            bool running = false;   // in run(), the callback is released after it returns
             bool paused = false;
 			float pauseStartTime = 0.0f;
+
+            ofxComponentBase* owner = nullptr; // only touched while not done
+            uint64_t id = 0;            // creation order, timers of one component run in this order
+            uint64_t scheduledSeq = 0;  // latest entry in the scheduler, older entries are stale
+            uint32_t index = 0;         // slot in the pool
+            uint32_t generation = 0;    // bumped when the slot is reused, 0 is never valid
+            int nextFree = -1;
+            void reschedule();
+        };
+
+        // Lightweight generational handle to a pooled timer.
+        // When the timer has finished and its slot was reused, the generation doesn't match anymore.
+        struct TimerHandle {
+            uint32_t index = 0;
+            uint32_t generation = 0;
+        };
+
+        // Thin wrapper of TimerHandle with the old shared_ptr<Timer> like API.
+        // timer->cancel(), timer->isDone() etc. are always safe: once the timer has finished
+        // and was recycled, it reports done and the other calls do nothing.
+        class TimerRef {
+        public:
+            TimerRef() {}
+            TimerRef(nullptr_t) {}
+            TimerRef(TimerHandle _handle) : handle(_handle) {}
+
+            void cancel() const;
+            bool isDone() const;
+            bool isPaused() const;
+            void setPaused(bool paused) const;
+            float getExecTime() const;  // 0 once recycled
+            void shiftExecTime(const float sec) const;
+
+            // keeps timer->cancel() working, the calls go to the ones above
+            const TimerRef* operator->() const { return this; }
+            explicit operator bool() const { return handle.generation != 0; }
+            bool operator==(const TimerRef& other) const { return handle.index == other.handle.index && handle.generation == other.handle.generation; }
+            bool operator!=(const TimerRef& other) const { return !(*this == other); }
+
+            TimerHandle getHandle() const { return handle; }
+            // the timer is still in the pool (may be done but not recycled yet)
+            bool isAlive() const;
+
+        private:
+            TimerHandle handle;
         };
 
-        typedef shared_ptr<Timer> TimerRef;
     private:
-		vector<TimerRef> timerFunctions;
-        vector<TimerRef> timerFunctionsToAdd;
+        // Rarely used state, allocated on first use so most components don't carry it
+        struct ColdData {
+            vector<TimerHandle> timerFunctions;
+            // Delivered by timerScheduler when elapsed, run in next update() of this component
+            vector<TimerHandle> dueTimers, runningTimers;
+        };
+        unique_ptr<ColdData> cold;
+        ColdData& getCold();
         void updateTimers();
+        // release done timers to the pool
+        void removeDoneTimers();
+        Timer* createTimer(float wait, TimerHandle& handle);
+        void startTimer(Timer* timer);
 	public:
-        shared_ptr<Timer> addTimerFunction(TimerFunc func, float wait);
+        // func runs once in update() of this component, in the first frame that starts after wait [sec],
+        // so one added during the update with wait 0 runs in the next frame.
+        TimerRef addTimerFunction(TimerFunc func, float wait);
+        // Any void() callable, stored without std::function. Small lambdas don't allocate.
+        template<typename F>
+        TimerRef addTimerFunction(F&& func, float wait) {
+            TimerHandle handle;
+            Timer* timer = createTimer(wait, handle);
+            timer->function.assign(std::forward<F>(func));
+            startTimer(timer);
+            return TimerRef(handle);
+        }
         vector<TimerRef> getTimerFunctions();
 		void clearTimerFunctions();
 
 	protected:
-		static vector<shared_ptr<ofxComponentBase> > allComponents;
+		// all started components, until removed after destroy()
+		static ofxComponentRegistry allComponents;
 		static vector<shared_ptr<ofxComponentBase> > destroyedComponents;
-        static shared_ptr<ofxComponentBase> mouseOverComponent;
+        static ofxComponentBase* mouseOverComponent;
+        // Incremented whenever children are added, removed or reordered anywhere
+        static unsigned int structureVersion;
+        // Incremented by ofxComponentManager every frame and mouse event
+        static unsigned int mouseVersion;
+        // Owned by ofxComponentManager, nullptr when disabled
+        static ofxComponentParallelUpdater* parallelUpdater;
+        // Owned by ofxComponentManager, nullptr when disabled
+        static ofxComponentFboPool* fboPool;
+        // Incremented for each parallel phase
+        static unsigned int parallelStamp;
+        // number of sleeping components, requestUpdate() does nothing while 0
+        static int numSleeping;
+        // Incremented when active, key/mouse enabled or destroyed changes anywhere
+        static unsigned int inputVersion;
+        // Incremented when active, destroyed, constrain or cache changes anywhere
+        static unsigned int drawVersion;
+        // Incremented when a draw interest changes anywhere. Only drops or adds draw calls,
+        // so the render list picks it up in the next frame without restarting the current one
+        static unsigned int drawInterestVersion;
+        // number of components with cacheAsBitmap, invalidateCache() does nothing while 0
+        static int numCaching;
+        // Set by ofxComponentManager. Visible area in global coordinates while drawing,
+        // narrowed to the rect of constrained and cached components for their children.
+        static bool culling;
+        static ofRectangle cullRect;
+        // Incremented when an input interest changes
+        static unsigned int inputInterestVersion;
+        // Owned by ofxComponentManager, nullptr when disabled
+        static ofxComponentSpatialIndex* spatialIndex;
+        // Owned by ofxComponentManager, nullptr when disabled
+        static ofxComponentTransformStore* transformStore;
+        // All timers of all components, ordered by exec time. Driven by ofxComponentManager::update()
+        static ofxComponentTimerScheduler& timerScheduler;
         bool timerPaused = false;
 	};
 }
@@ -0,0 +1,104 @@
+#include "ofxComponentClipStack.h"
+
+using namespace ofxComponent;
+
+vector<ofRectangle> ofxComponentClipStack::rects;
+vector<size_t> ofxComponentClipStack::surfaces;
+bool ofxComponentClipStack::outerSaved = false;
+bool ofxComponentClipStack::outerEnabled = false;
+ofRectangle ofxComponentClipStack::outerBox;
+
+bool ofxComponentClipStack::getScissorRect(float width, float height, ofRectangle& result) {
+    ofMatrix4x4 mvp = ofMatrix4x4(ofGetCurrentMatrix(OF_MATRIX_MODELVIEW)) * ofMatrix4x4(ofGetCurrentMatrix(OF_MATRIX_PROJECTION));
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    
+    ofVec2f corners[4];
+    ofVec2f local[4] = { ofVec2f(0, 0), ofVec2f(width, 0), ofVec2f(width, height), ofVec2f(0, height) };
+    for (int i = 0; i < 4; ++i) {
+        ofVec3f ndc = mvp.preMult(ofVec3f(local[i].x, local[i].y, 0));
+        corners[i].x = viewport[0] + (ndc.x + 1) * 0.5f * viewport[2];
+        corners[i].y = viewport[1] + (ndc.y + 1) * 0.5f * viewport[3];
+    }
+    
+    // the edges must stay horizontal / vertical (any flip or 90 degree steps are fine)
+    const float eps = 0.01f;
+    bool aligned =
+        (fabsf(corners[0].y - corners[1].y) < eps && fabsf(corners[1].x - corners[2].x) < eps &&
+         fabsf(corners[2].y - corners[3].y) < eps && fabsf(corners[3].x - corners[0].x) < eps) ||
+        (fabsf(corners[0].x - corners[1].x) < eps && fabsf(corners[1].y - corners[2].y) < eps &&
+         fabsf(corners[2].x - corners[3].x) < eps && fabsf(corners[3].y - corners[0].y) < eps);
+    if (!aligned) return false;
+    
+    // pixels whose centers are inside, as the rasterizer does
+    float x0 = MIN(corners[0].x, corners[2].x), x1 = MAX(corners[0].x, corners[2].x);
+    float y0 = MIN(corners[0].y, corners[2].y), y1 = MAX(corners[0].y, corners[2].y);
+    x0 = roundf(x0);
+    y0 = roundf(y0);
+    result.set(x0, y0, MAX(0, roundf(x1) - x0), MAX(0, roundf(y1) - y0));
+    return true;
+}
+
+void ofxComponentClipStack::push(const ofRectangle& rect) {
+    saveOuter();
+    ofRectangle r = rect;
+    if (isClipping()) {
+        r = r.getIntersection(rects.back());
+    }
+    else if (surfaces.empty() && outerEnabled) {
+        r = r.getIntersection(outerBox);
+    }
+    rects.push_back(r);
+    apply();
+}
+
+void ofxComponentClipStack::pop() {
+    if (rects.empty()) return;
+    rects.pop_back();
+    apply();
+}
+
+void ofxComponentClipStack::beginSurface() {
+    saveOuter();
+    surfaces.push_back(rects.size());
+    apply();
+}
+
+void ofxComponentClipStack::endSurface() {
+    if (surfaces.empty()) return;
+    surfaces.pop_back();
+    apply();
+}
+
+bool ofxComponentClipStack::isClipping() {
+    size_t begin = surfaces.empty() ? 0 : surfaces.back();
+    return rects.size() > begin;
+}
+
+void ofxComponentClipStack::saveOuter() {
+    if (outerSaved || !rects.empty() || !surfaces.empty()) return;
+    outerEnabled = glIsEnabled(GL_SCISSOR_TEST);
+    GLint box[4];
+    glGetIntegerv(GL_SCISSOR_BOX, box);
+    outerBox.set(box[0], box[1], box[2], box[3]);
+    outerSaved = true;
+}
+
+void ofxComponentClipStack::apply() {
+    if (!isClipping()) {
+        // an fbo surface starts unclipped, the window gets the scissor of the app back
+        if (!surfaces.empty() || !outerEnabled) {
+            glDisable(GL_SCISSOR_TEST);
+        }
+        else {
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(outerBox.x, outerBox.y, outerBox.width, outerBox.height);
+        }
+        // read again next time, the app may change it between draws
+        if (rects.empty() && surfaces.empty()) outerSaved = false;
+        return;
+    }
+    auto& r = rects.back();
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(r.x, r.y, r.width, r.height);
+}
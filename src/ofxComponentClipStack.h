@@ -0,0 +1,37 @@
+#pragma once
+#include "ofMain.h"
+
+namespace ofxComponent {
+	// Nested scissor rectangles for constrained components.
+	// Rectangles are in framebuffer pixels of the current render target,
+	// each one is intersected with the one it is nested in.
+	// Rendering into an fbo starts a new surface with no clip, and ends it restoring the outer clip.
+	// A scissor set by the app around the draw is kept: the first push intersects with it,
+	// and it is restored once the stack is empty.
+	class ofxComponentClipStack {
+	public:
+		// Rect (0, 0, width, height) of the current matrix, in framebuffer pixels.
+		// false if it isn't an axis aligned rectangle on screen (rotated, skewed, perspective).
+		static bool getScissorRect(float width, float height, ofRectangle& result);
+
+		static void push(const ofRectangle& rect);
+		static void pop();
+
+		static void beginSurface();
+		static void endSurface();
+
+		// clipped by a scissor in the current surface
+		static bool isClipping();
+
+	private:
+		static void apply();
+		// scissor state of the app, read before the first change
+		static void saveOuter();
+
+		static vector<ofRectangle> rects;
+		static vector<size_t> surfaces; // first index in rects of each surface
+		static bool outerSaved;
+		static bool outerEnabled;
+		static ofRectangle outerBox;
+	};
+}
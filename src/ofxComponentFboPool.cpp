@@ -0,0 +1,86 @@
+#include "ofxComponentFboPool.h"
+
+using namespace ofxComponent;
+
+ofxComponentFboPool::~ofxComponentFboPool() {
+    if (!used.empty()) {
+        ofLogWarning() << "~ofxComponentFboPool(): " << used.size() << " render targets still in use";
+    }
+}
+
+ofFbo* ofxComponentFboPool::acquire(int width, int height) {
+    SizeClass size(roundUp(MAX(1, width)), roundUp(MAX(1, height)));
+    
+    Entry e;
+    auto& list = freeLists[size];
+    if (!list.empty()) {
+        e = std::move(list.back());
+        list.pop_back();
+        --stats.pooled;
+        ++stats.reuses;
+    }
+    else {
+        e.fbo = make_unique<ofFbo>();
+        e.fbo->allocate(size.first, size.second, GL_RGBA);
+        ++stats.allocations;
+        stats.bytes += getBytes(size);
+    }
+    
+    ofFbo* fbo = e.fbo.get();
+    used[fbo] = std::move(e);
+    ++stats.inUse;
+    return fbo;
+}
+
+void ofxComponentFboPool::release(ofFbo* fbo) {
+    auto itr = used.find(fbo);
+    if (itr == used.end()) {
+        ofLogWarning() << "ofxComponentFboPool::release(): not from this pool";
+        return;
+    }
+    
+    Entry e = std::move(itr->second);
+    used.erase(itr);
+    --stats.inUse;
+    
+    e.lastUsedFrame = frame;
+    SizeClass size(fbo->getWidth(), fbo->getHeight());
+    freeLists[size].push_back(std::move(e));
+    ++stats.pooled;
+}
+
+void ofxComponentFboPool::update() {
+    ++frame;
+    for (auto itr = freeLists.begin(); itr != freeLists.end();) {
+        auto& list = itr->second;
+        // oldest at the front, the most recently released at the back
+        size_t idle = 0;
+        while (idle < list.size() && frame - list[idle].lastUsedFrame > (uint64_t)maxIdleFrames) ++idle;
+        if (idle > 0) {
+            stats.evictions += idle;
+            stats.pooled -= idle;
+            stats.bytes -= getBytes(itr->first) * idle;
+            list.erase(list.begin(), list.begin() + idle);
+        }
+        if (list.empty()) itr = freeLists.erase(itr);
+        else ++itr;
+    }
+}
+
+void ofxComponentFboPool::clear() {
+    for (auto& f : freeLists) {
+        stats.evictions += f.second.size();
+        stats.bytes -= getBytes(f.first) * f.second.size();
+    }
+    freeLists.clear();
+    stats.pooled = 0;
+}
+
+int ofxComponentFboPool::roundUp(int v) {
+    return ((v + sizeStep - 1) / sizeStep) * sizeStep;
+}
+
+size_t ofxComponentFboPool::getBytes(const SizeClass& size) {
+    // RGBA8
+    return (size_t)size.first * size.second * 4;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "ofMain.h"
+
+namespace ofxComponent {
+	// Render targets shared by all constrained components.
+	// A component takes one for the time of its draw and gives it back,
+	// so the pool only holds as many as are nested at once, for each size class.
+	// Sizes are rounded up to a multiple of sizeStep, so resizing a window doesn't allocate every frame.
+	// Render targets unused for a while are freed in update().
+	class ofxComponentFboPool {
+	public:
+		struct Stats {
+			int allocations = 0; // ofFbo::allocate() calls so far
+			int reuses = 0;      // acquire() served from the pool so far
+			int evictions = 0;   // freed because unused so far
+			int inUse = 0;
+			int pooled = 0;      // free, ready to be reused
+			size_t bytes = 0;    // estimated, all render targets of the pool
+		};
+
+		~ofxComponentFboPool();
+
+		// at least width x height, draw only that part of it
+		ofFbo* acquire(int width, int height);
+		void release(ofFbo* fbo);
+
+		// once per frame, frees render targets unused for maxIdleFrames
+		void update();
+		void setMaxIdleFrames(int frames) { maxIdleFrames = frames; }
+		// free all unused now
+		void clear();
+
+		const Stats& getStats() const { return stats; }
+
+		static const int sizeStep = 64;
+
+	private:
+		struct Entry {
+			unique_ptr<ofFbo> fbo;
+			uint64_t lastUsedFrame = 0;
+		};
+		typedef pair<int, int> SizeClass;
+
+		static int roundUp(int v);
+		static size_t getBytes(const SizeClass& size);
+
+		map<SizeClass, vector<Entry> > freeLists;
+		unordered_map<ofFbo*, Entry> used;
+		uint64_t frame = 0;
+		int maxIdleFrames = 120;
+		Stats stats;
+	};
+}
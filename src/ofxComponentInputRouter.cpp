@@ -0,0 +1,80 @@
+#include "ofxComponentInputRouter.h"
+
+using namespace ofxComponent;
+
+ofxComponentInputRouter::ofxComponentInputRouter(ofxComponentBase* _root)
+: root(_root)
+{
+}
+
+bool ofxComponentInputRouter::isReachable(ofxComponentBase* c) {
+    refresh();
+    return c && c->inputBuildStamp == buildStamp;
+}
+
+size_t ofxComponentInputRouter::size(InputEventType type) {
+    refresh();
+    return lists[toSlot(type)].size();
+}
+
+void ofxComponentInputRouter::refresh() {
+    if (built &&
+        builtStructureVersion == ofxComponentBase::structureVersion &&
+        builtInputVersion == ofxComponentBase::inputVersion &&
+        builtInterestVersion == ofxComponentBase::inputInterestVersion) {
+        return;
+    }
+    rebuild();
+}
+
+void ofxComponentInputRouter::rebuild() {
+    for (auto& l : lists) l.clear();
+    ++buildStamp;
+    
+    // pre-order, children pushed in reverse
+    unsigned int order = 0;
+    resumeOrder = 0;
+    walkStack.clear();
+    walkStack.push_back(root);
+    while (!walkStack.empty()) {
+        auto c = walkStack.back();
+        walkStack.pop_back();
+        
+        // the recursive dispatch stops here
+        if (!c->isActive || c->destroyed || !c->keyMouseEventEnabled) continue;
+        
+        c->inputBuildStamp = buildStamp;
+        c->inputOrder = order++;
+        if (c->inputDispatchStamp == dispatchStamp) resumeOrder = order;
+        for (int t = 0; t < numTypes; ++t) {
+            if (c->inputInterest & (1 << t)) lists[t].push_back(c);
+        }
+        
+        auto children = c->getChildrenView();
+        for (size_t i = children.size(); i > 0; --i) {
+            walkStack.push_back(children[i - 1]);
+        }
+    }
+    
+    built = true;
+    builtStructureVersion = ofxComponentBase::structureVersion;
+    builtInputVersion = ofxComponentBase::inputVersion;
+    builtInterestVersion = ofxComponentBase::inputInterestVersion;
+}
+
+void ofxComponentInputRouter::collectExtra(initializer_list<ofxComponentBase*> extra, unsigned int afterOrder) {
+    extraNodes.clear();
+    for (auto c : extra) {
+        if (c == nullptr || c->inputBuildStamp != buildStamp || c->inputOrder < afterOrder) continue;
+        extraNodes.push_back(c);
+    }
+    sort(extraNodes.begin(), extraNodes.end(), [](ofxComponentBase* a, ofxComponentBase* b) {
+        return a->inputOrder < b->inputOrder;
+    });
+}
+
+int ofxComponentInputRouter::toSlot(InputEventType type) {
+    int slot = 0;
+    while (slot < numTypes - 1 && (1 << slot) != type) ++slot;
+    return slot;
+}
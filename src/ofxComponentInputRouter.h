@@ -0,0 +1,90 @@
+#pragma once
+#include "ofMain.h"
+#include "ofxComponentBase.h"
+
+namespace ofxComponent {
+	// Per event type list of the components that handle it, in the same order as the recursive dispatch.
+	// Components are reachable from the root through active, enabled, not destroyed components only,
+	// like the recursion would stop at them.
+	// The lists are rebuilt lazily when the tree, active/enabled state or an interest changes.
+	class ofxComponentInputRouter {
+	public:
+		ofxComponentInputRouter(ofxComponentBase* root);
+
+		// Call handler(ofxComponentBase&) for every component interested in type.
+		// extra are visited too when reachable, even without interest (mouse over, moving component).
+		// Handlers may change the tree: the lists are rebuilt and the dispatch continues after
+		// the last visited component, so no one gets the event twice.
+		template<typename F>
+		void dispatch(InputEventType type, initializer_list<ofxComponentBase*> extra, F&& handler);
+
+		// c is reachable in the current lists
+		bool isReachable(ofxComponentBase* c);
+
+		size_t size(InputEventType type);
+
+	private:
+		void refresh();
+		void rebuild();
+		void collectExtra(initializer_list<ofxComponentBase*> extra, unsigned int afterOrder);
+		static int toSlot(InputEventType type);
+
+		ofxComponentBase* root;
+		bool built = false;
+		unsigned int builtStructureVersion = 0;
+		unsigned int builtInputVersion = 0;
+		unsigned int builtInterestVersion = 0;
+		unsigned int buildStamp = 0;
+		unsigned int dispatchStamp = 0;
+		unsigned int resumeOrder = 0; // after the last component visited by the current dispatch
+
+		static const int numTypes = 8;
+		vector<ofxComponentBase*> lists[numTypes];
+		vector<ofxComponentBase*> extraNodes;
+		vector<ofxComponentBase*> walkStack;
+	};
+
+	template<typename F>
+	void ofxComponentInputRouter::dispatch(InputEventType type, initializer_list<ofxComponentBase*> extra, F&& handler) {
+		refresh();
+		unsigned int stamp = ++dispatchStamp;
+		int slot = toSlot(type);
+		size_t i = 0;
+		collectExtra(extra, 0);
+		size_t e = 0;
+
+		while (true) {
+			auto& list = lists[slot];
+			// next in paint order, from the list or the extras
+			ofxComponentBase* c = nullptr;
+			bool fromList = false;
+			if (i < list.size()) {
+				c = list[i];
+				fromList = true;
+			}
+			if (e < extraNodes.size() && (c == nullptr || extraNodes[e]->inputOrder < c->inputOrder)) {
+				c = extraNodes[e];
+				fromList = false;
+			}
+			if (c == nullptr) break;
+			if (fromList) ++i;
+			else ++e;
+
+			if (c->inputDispatchStamp == stamp) continue;
+			c->inputDispatchStamp = stamp;
+
+			unsigned int sv = ofxComponentBase::structureVersion;
+			unsigned int iv = ofxComponentBase::inputVersion;
+			handler(*c);
+			if (sv == ofxComponentBase::structureVersion && iv == ofxComponentBase::inputVersion) continue;
+
+			// changed by the handler, continue after the last visited component in the new order
+			rebuild();
+			auto& rebuilt = lists[slot];
+			i = 0;
+			while (i < rebuilt.size() && rebuilt[i]->inputOrder < resumeOrder) ++i;
+			collectExtra(extra, resumeOrder);
+			e = 0;
+		}
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "ofMain.h"
+
+namespace ofxComponent {
+	// ofEvent<void> created when the first listener is added, so components nobody listens to don't carry one.
+	// ofAddListener(), ofRemoveListener() and ofNotifyEvent() take it like an ofEvent<void>,
+	// the overloads below are found through the argument.
+	class ofxComponentLazyEvent {
+	public:
+		ofxComponentLazyEvent() {}
+		ofxComponentLazyEvent(const ofxComponentLazyEvent&) = delete;
+		ofxComponentLazyEvent& operator=(const ofxComponentLazyEvent&) = delete;
+
+		ofEvent<void>& get() {
+			if (!event) event = make_unique<ofEvent<void> >();
+			return *event;
+		}
+		operator ofEvent<void>&() { return get(); }
+		// false until a listener was added
+		bool isCreated() const { return event != nullptr; }
+
+		void notify() {
+			if (event) ::ofNotifyEvent(*event);
+		}
+
+		template<typename... Args>
+		auto newListener(Args&&... args) -> decltype(declval<ofEvent<void>&>().newListener(std::forward<Args>(args)...)) {
+			return get().newListener(std::forward<Args>(args)...);
+		}
+
+	private:
+		unique_ptr<ofEvent<void> > event;
+	};
+
+	template<class ListenerClass, typename ListenerMethod>
+	void ofAddListener(ofxComponentLazyEvent& event, ListenerClass* listener, ListenerMethod method, int prio = OF_EVENT_ORDER_AFTER_APP) {
+		::ofAddListener(event.get(), listener, method, prio);
+	}
+
+	template<class ListenerClass, typename ListenerMethod>
+	void ofRemoveListener(ofxComponentLazyEvent& event, ListenerClass* listener, ListenerMethod method, int prio = OF_EVENT_ORDER_AFTER_APP) {
+		if (event.isCreated()) ::ofRemoveListener(event.get(), listener, method, prio);
+	}
+
+	inline void ofNotifyEvent(ofxComponentLazyEvent& event) {
+		event.notify();
+	}
+}
@@ -4,10 +4,25 @@
 namespace ofxComponent {
     shared_ptr<ofxComponentManager> ofxComponentManager::singleton = nullptr;
     
+    namespace {
+        // handlers may remove it from the tree, and the router still reads it afterwards
+        shared_ptr<ofxComponentBase> keepAlive(ofxComponentBase* c) {
+            return c ? c->getThis() : nullptr;
+        }
+    }
+    
     ofxComponentManager::ofxComponentManager() {
+        // the root holds the whole scene, its rect is not the window
+        childrenDrawOutside = true;
     }
     
     ofxComponentManager::~ofxComponentManager() {
+        setSpatialIndexEnabled(false);
+        setTransformStoreEnabled(false);
+        setParallelUpdateEnabled(false);
+        setFboPoolEnabled(false);
+        setCullingEnabled(false);
+        setProfilingEnabled(false);
         ofRemoveListener(ofEvents().update, this, &ofxComponentManager::update, OF_EVENT_ORDER_BEFORE_APP);
         ofRemoveListener(ofEvents().draw, this, &ofxComponentManager::draw, OF_EVENT_ORDER_BEFORE_APP);
         ofRemoveListener(ofEvents().exit, this, &ofxComponentManager::exit, OF_EVENT_ORDER_BEFORE_APP);
@@ -38,89 +53,383 @@ namespace ofxComponent {
     }
     
     void ofxComponentManager::update(ofEventArgs &args) {
+        // local mouse positions are computed again, once per component
+        ++mouseVersion;
+        if (transforms) transforms->update();
+        // hand elapsed timers to their components, they run in ofxComponentBase::update()
+        timerScheduler.update(ofGetElapsedTimef());
+        if (updater) updateParallelSubtrees();
         ofxComponentBase::update(args);
         
-        removeDestroyedObjects();
+        OFX_COMPONENT_PROFILE(this, ProfileRemoveDestroyed, removeDestroyedObjects(false));
     }
     void ofxComponentManager::draw(ofEventArgs &args) {
+        if (fbos) fbos->update();
+        if (culling) cullRect = getCullRect();
+        if (renderList) {
+            renderList->draw(args);
+            return;
+        }
         ofxComponentBase::draw(args);
     }
     void ofxComponentManager::exit(ofEventArgs &args) {
         destroy();
-        removeDestroyedObjects();
+        flushDestroyedObjects();
         ofxComponentBase::exit(args);
     }
     void ofxComponentManager::keyPressed(ofKeyEventArgs &key) {
+        if (router) {
+            router->dispatch(InputKeyPressed, {}, [&](ofxComponentBase& c) { OFX_COMPONENT_PROFILE(&c, ProfileInput, c.onKeyPressed(key)); });
+            return;
+        }
         ofxComponentBase::keyPressed(key);
     }
     void ofxComponentManager::keyReleased(ofKeyEventArgs &key) {
+        if (router) {
+            router->dispatch(InputKeyReleased, {}, [&](ofxComponentBase& c) { OFX_COMPONENT_PROFILE(&c, ProfileInput, c.onKeyReleased(key)); });
+            return;
+        }
         ofxComponentBase::keyReleased(key);
     }
     void ofxComponentManager::mouseMoved(ofMouseEventArgs &mouse) {
         checkMostTopComponent();
+        if (router) {
+            router->dispatch(InputMouseMoved, {}, [&](ofxComponentBase& c) { OFX_COMPONENT_PROFILE(&c, ProfileInput, c.onMouseMoved(mouse)); });
+            return;
+        }
         ofxComponentBase::mouseMoved(mouse);
     }
     void ofxComponentManager::mousePressed(ofMouseEventArgs &mouse) {
         checkMostTopComponent();
+        if (router) {
+            // the component under the mouse gets onMousePressedOverComponent() even without interest
+            auto over = keepAlive(mouseOverComponent);
+            router->dispatch(InputMousePressed, { over.get() }, [&](ofxComponentBase& c) { c.handleMousePressed(mouse); });
+            return;
+        }
         ofxComponentBase::mousePressed(mouse);
     }
     void ofxComponentManager::mouseDragged(ofMouseEventArgs &mouse) {
         checkMostTopComponent();
+        if (router) {
+            auto moving = keepAlive(movingComponent);
+            router->dispatch(InputMouseDragged, { moving.get() }, [&](ofxComponentBase& c) { c.handleMouseDragged(mouse); });
+            return;
+        }
         ofxComponentBase::mouseDragged(mouse);
     }
     void ofxComponentManager::mouseReleased(ofMouseEventArgs &mouse) {
         checkMostTopComponent();
+        if (router) {
+            auto moving = keepAlive(movingComponent);
+            auto pressed = keepAlive(pressedOverComponent);
+            // reset even if it can't get the event, as the recursion does
+            if (pressed && !router->isReachable(pressed.get())) pressed->mousePressedOverComponent = false;
+            pressedOverComponent = nullptr;
+            router->dispatch(InputMouseReleased, { moving.get(), pressed.get() }, [&](ofxComponentBase& c) { c.handleMouseReleased(mouse); });
+            return;
+        }
+        // the recursion skips inactive subtrees, don't keep a press over one of them
+        auto pressed = keepAlive(pressedOverComponent);
+        pressedOverComponent = nullptr;
         ofxComponentBase::mouseReleased(mouse);
+        if (pressed) pressed->mousePressedOverComponent = false;
     }
     void ofxComponentManager::mouseScrolled(ofMouseEventArgs &mouse) {
         checkMostTopComponent();
+        if (router) {
+            router->dispatch(InputMouseScrolled, {}, [&](ofxComponentBase& c) { OFX_COMPONENT_PROFILE(&c, ProfileInput, c.onMouseScrolled(mouse)); });
+            return;
+        }
         ofxComponentBase::mouseScrolled(mouse);
     }
     void ofxComponentManager::dragEvent(ofDragInfo &dragInfo) {
         checkMostTopComponent();
+        if (router) {
+            router->dispatch(InputDragEvent, {}, [&](ofxComponentBase& c) { OFX_COMPONENT_PROFILE(&c, ProfileInput, c.onDragEvent(dragInfo)); });
+            return;
+        }
         ofxComponentBase::dragEvent(dragInfo);
     }
     
+    void ofxComponentManager::setSpatialIndexEnabled(bool enabled) {
+        if (enabled == getSpatialIndexEnabled()) return;
+        
+        if (enabled) {
+            ofRectangle bounds = getGlobalBounds();
+            if (bounds.width <= 0 || bounds.height <= 0) {
+                bounds = ofRectangle(0, 0, ofGetWidth(), ofGetHeight());
+            }
+            index = make_unique<ofxComponentSpatialIndex>(this, bounds);
+            spatialIndex = index.get();
+        }
+        else {
+            spatialIndex = nullptr;
+            index.reset();
+        }
+    }
+    
+    bool ofxComponentManager::getSpatialIndexEnabled() {
+        return index != nullptr;
+    }
+    
+    void ofxComponentManager::setTransformStoreEnabled(bool enabled) {
+        if (enabled == getTransformStoreEnabled()) return;
+        
+        if (enabled) {
+            transforms = make_unique<ofxComponentTransformStore>(this);
+            transformStore = transforms.get();
+            transforms->update();
+        }
+        else {
+            transformStore = nullptr;
+            transforms.reset();
+        }
+    }
+    
+    bool ofxComponentManager::getTransformStoreEnabled() {
+        return transforms != nullptr;
+    }
+    
     void ofxComponentManager::checkMostTopComponent() {
-        mouseOverComponent = nullptr;
-        std::function<void(vector<shared_ptr<ofxComponentBase> >)> checkMostTop = [&](vector<shared_ptr<ofxComponentBase> > list){
-            for (shared_ptr<ofxComponentBase> c : list) {
-                if (!c->getActive()) continue;
-                vector<shared_ptr<ofxComponentBase> > clist = c->getChildren();
-                if (c->isMouseInside()) {
-                    mouseOverComponent = c;
-                    if (c->getConstrain()) {
-                        checkMostTop(clist);
-                    }
-                }
-                if (!c->getConstrain()) {
-                    checkMostTop(clist);
+        // the mouse moved, this hit test fills the local mouse positions for the handlers
+        ++mouseVersion;
+        if (index) {
+            // candidates come frontmost first, the first one that really hits wins
+            index->query(ofVec2f(ofGetMouseX(), ofGetMouseY()), hitCandidates);
+            for (auto c : hitCandidates) {
+                if (isHitTestable(c)) {
+                    setMouseOverComponent(c);
+                    return;
                 }
             }
-        };
+            setMouseOverComponent(nullptr);
+            return;
+        }
+        
+        ofxComponentBase* top = nullptr;
+        walkDescendants([&](ofxComponentBase& c) {
+            if (!c.getActive() || c.isDestroyed()) return false;
+            bool inside = c.isMouseInside();
+            if (inside) top = &c;
+            // children of a constrained component can be hit only inside of it
+            return !isClippedOut(&c);
+        });
+        setMouseOverComponent(top);
+    }
+    
+    bool ofxComponentManager::isHitTestable(ofxComponentBase* c) {
+        // same rules as the full walk: active all the way up,
+        // and inside every constrained ancestor
+        if (!c->getActive() || c->isDestroyed() || !c->isMouseInside()) return false;
         
-        auto list = getChildren();
-        checkMostTop(list);
+        auto p = c->getParent().get();
+        while (p != this) {
+            if (p == nullptr) return false;
+            if (!p->getActive() || p->isDestroyed()) return false;
+            if (isClippedOut(p)) return false;
+            p = p->getParent().get();
+        }
+        return true;
+    }
+    
+    void ofxComponentManager::setInputRoutingEnabled(bool enabled) {
+        if (enabled == getInputRoutingEnabled()) return;
+        
+        if (enabled) router = make_unique<ofxComponentInputRouter>(this);
+        else router.reset();
+    }
+    
+    bool ofxComponentManager::getInputRoutingEnabled() {
+        return router != nullptr;
+    }
+    
+    void ofxComponentManager::setRetainedDrawEnabled(bool enabled) {
+        if (enabled == getRetainedDrawEnabled()) return;
+        
+        if (enabled) renderList = make_unique<ofxComponentRenderList>(this);
+        else renderList.reset();
+    }
+    
+    bool ofxComponentManager::getRetainedDrawEnabled() {
+        return renderList != nullptr;
+    }
+    
+    void ofxComponentManager::setFboPoolEnabled(bool enabled) {
+        if (enabled == getFboPoolEnabled()) return;
+        
+        if (enabled) {
+            fbos = make_unique<ofxComponentFboPool>();
+            fboPool = fbos.get();
+        }
+        else {
+            fboPool = nullptr;
+            fbos.reset();
+        }
+    }
+    
+    bool ofxComponentManager::getFboPoolEnabled() {
+        return fbos != nullptr;
     }
     
-    void ofxComponentManager::removeDestroyedObjects() {
+    void ofxComponentManager::setCullingEnabled(bool enabled) {
+        if (enabled == culling) return;
+        culling = enabled;
+        ++drawVersion;
+    }
+    
+    bool ofxComponentManager::getCullingEnabled() {
+        return culling;
+    }
+    
+    void ofxComponentManager::setCullRect(const ofRectangle& rect) {
+        userCullRect = rect;
+        userCullRect.standardize();
+        hasUserCullRect = true;
+    }
+    
+    void ofxComponentManager::clearCullRect() {
+        hasUserCullRect = false;
+    }
+    
+    ofRectangle ofxComponentManager::getCullRect() {
+        if (hasUserCullRect) return userCullRect;
+        ofRectangle viewport = ofGetCurrentViewport();
+        return ofRectangle(0, 0, viewport.width, viewport.height);
+    }
+    
+    void ofxComponentManager::setProfilingEnabled(bool enabled, size_t capacity) {
+#ifndef OFX_COMPONENT_PROFILING
+        if (enabled) {
+            ofLogWarning("ofxComponentManager") << "setProfilingEnabled(): define OFX_COMPONENT_PROFILING to record anything";
+        }
+#endif
+        if (enabled) {
+            profiler = make_unique<ofxComponentProfiler>(capacity);
+            ofxComponentProfiler::active = profiler.get();
+        }
+        else {
+            if (ofxComponentProfiler::active == profiler.get()) ofxComponentProfiler::active = nullptr;
+            profiler.reset();
+        }
+    }
+    
+    bool ofxComponentManager::getProfilingEnabled() {
+        return profiler != nullptr;
+    }
+    
+    bool ofxComponentManager::saveProfileTrace(const string& path) {
+        if (!profiler) {
+            ofLogWarning("ofxComponentManager") << "saveProfileTrace(): profiling is not enabled";
+            return false;
+        }
+        return profiler->saveChromeTrace(path);
+    }
+    
+    string ofxComponentManager::getProfileReport() {
+        if (!profiler) return "";
+        return profiler->getReport();
+    }
+    
+    ofxComponentFboPool::Stats ofxComponentManager::getFboPoolStats() {
+        if (fbos) return fbos->getStats();
+        return ofxComponentFboPool::Stats();
+    }
+    
+    void ofxComponentManager::setParallelUpdateEnabled(bool enabled, int numThreads) {
+        if (!enabled) {
+            parallelUpdater = nullptr;
+            updater.reset();
+            return;
+        }
+        if (updater && (numThreads <= 0 || updater->getNumThreads() == numThreads)) return;
+        
+        parallelUpdater = nullptr;
+        updater = make_unique<ofxComponentParallelUpdater>(numThreads);
+        parallelUpdater = updater.get();
+    }
+    
+    bool ofxComponentManager::getParallelUpdateEnabled() {
+        return updater != nullptr;
+    }
+    
+    void ofxComponentManager::updateParallelSubtrees() {
+        parallelRoots.clear();
+        walkDescendants([&](ofxComponentBase& c) {
+            // same conditions as update()
+            if (c.isDestroyed() || !c.getActive() || c.isSleeping()) return false;
+            if (c.getThreadSafeUpdate()) {
+                parallelRoots.push_back(&c);
+                return false;
+            }
+            return true;
+        });
+        if (parallelRoots.empty()) return;
+        
+        // Global matrices are computed lazily when read.
+        // Make them up to date here, so that tasks reading their parents don't write them at the same time.
+        if (transforms) transforms->update();
+        for (auto c : parallelRoots) {
+            auto p = c->getParent();
+            if (p) {
+                p->updateGlobalMatrix();
+                p->updateGlobalMatrixInverse();
+            }
+        }
+        
+        ++parallelStamp;
+        updater->run(parallelRoots);
+    }
+    
+    void ofxComponentManager::setDestroyBudget(float maxMillis, int maxComponents) {
+        destroyBudgetMillis = MAX(0, maxMillis);
+        destroyBudgetCount = MAX(0, maxComponents);
+    }
+    
+    void ofxComponentManager::flushDestroyedObjects() {
+        removeDestroyedObjects(true);
+    }
+    
+    size_t ofxComponentManager::getNumPendingDestroy() {
+        return destroyedComponents.size();
+    }
+    
+    bool ofxComponentManager::isClippedOut(ofxComponentBase* c) {
+        // draw clips to the rect with a scissor or an fbo, both are the same here
+        return c->getConstrain() && !c->isMouseInside();
+    }
+    
+    void ofxComponentManager::removeDestroyedObjects(bool force) {
+        if (destroyedComponents.empty()) return;
+        
+        bool limited = !force && (destroyBudgetMillis > 0 || destroyBudgetCount > 0);
+        uint64_t deadline = ofGetElapsedTimeMicros() + (uint64_t)(destroyBudgetMillis * 1000);
+        
         // remove destroyed object
-        while (!destroyedComponents.empty()) {
-            auto c = destroyedComponents.front();
-            if (c->isDestroyed()) {
-                for (auto& cc : c->getChildren()) {
-                    cc->removeParent();
-                }
-                c->removeParent();
-                
-                c->onDestroy();
-                destroyedComponents.erase(destroyedComponents.begin());
-                
-                auto itr = find(allComponents.begin(), allComponents.end(), c);
-                if (itr != allComponents.end()) {
-                    allComponents.erase(itr);
-                }
+        // onDestroy() may destroy more, they are appended and handled in this loop too
+        size_t i = 0;
+        for (; i < destroyedComponents.size(); ++i) {
+            if (limited) {
+                if (destroyBudgetCount > 0 && i >= (size_t)destroyBudgetCount) break;
+                if (destroyBudgetMillis > 0 && i > 0 && ofGetElapsedTimeMicros() >= deadline) break;
             }
+            
+            // released at the end of this iteration, so its destructor counts for the budget too
+            auto c = std::move(destroyedComponents[i]);
+            if (!c->isDestroyed()) continue;
+            
+            // children are still in the list, they are handled later, maybe in a later frame
+            c->removeAllChildren();
+            
+            // siblings destroyed together leave the parent in one pass,
+            // after that their parent is already nullptr
+            auto p = c->getParent();
+            if (p) p->removeDestroyedChildren();
+            
+            c->onDestroy();
+            
+            allComponents.remove(c->getHandle());
         }
+        destroyedComponents.erase(destroyedComponents.begin(), destroyedComponents.begin() + i);
     }
 }
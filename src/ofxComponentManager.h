@@ -1,8 +1,18 @@
 #pragma once
 #include "ofxComponentBase.h"
+#include "ofxComponentSpatialIndex.h"
+#include "ofxComponentTransformStore.h"
+#include "ofxComponentTimerScheduler.h"
+#include "ofxComponentRegistry.h"
+#include "ofxComponentInputRouter.h"
+#include "ofxComponentParallelUpdater.h"
+#include "ofxComponentRenderList.h"
+#include "ofxComponentFboPool.h"
+#include "ofxComponentProfiler.h"
 
 namespace ofxComponent {
 	class ofxComponentManager : public ofxComponentBase {
+		OFX_COMPONENT_TYPE(ofxComponentManager, ofxComponentBase)
 	public:
 		ofxComponentManager();
 		~ofxComponentManager();
@@ -20,9 +30,90 @@ namespace ofxComponent {
 		void mouseScrolled(ofMouseEventArgs &);
 		void dragEvent(ofDragInfo &);
         
+        // Use a quadtree over global bounds to find the topmost component under the mouse.
+        // Worth enabling with thousands of components. Disabled by default.
+        void setSpatialIndexEnabled(bool enabled);
+        bool getSpatialIndexEnabled();
+        
+        // Keep all transforms in flat arrays and compute global matrices in one SIMD pass per frame.
+        // Worth enabling with tens of thousands of components that move every frame. Disabled by default.
+        void setTransformStoreEnabled(bool enabled);
+        bool getTransformStoreEnabled();
+        
+        // Deliver key and mouse events only to components that handle them (see setInputInterest()),
+        // instead of visiting every active component. Same order as the recursive dispatch. Disabled by default.
+        void setInputRoutingEnabled(bool enabled);
+        bool getInputRoutingEnabled();
+        
+        // Draw from a flat list of draw calls with cached global matrices, instead of walking the tree
+        // with matrix and style pushes on every component. Disabled by default.
+        void setRetainedDrawEnabled(bool enabled);
+        bool getRetainedDrawEnabled();
+        
+        // Constrained components draw in render targets shared from a pool,
+        // instead of each one owning an fbo of its exact size. Disabled by default.
+        void setFboPoolEnabled(bool enabled);
+        bool getFboPoolEnabled();
+        // all zero while disabled
+        ofxComponentFboPool::Stats getFboPoolStats();
+        
+        // Skip drawing components whose global bounds are outside the window or the rect of a constrained parent.
+        // Children are assumed to draw inside their parent's rect, see setChildrenDrawOutside(). Disabled by default.
+        void setCullingEnabled(bool enabled);
+        bool getCullingEnabled();
+        // View rect for culling, in the global coordinates of the components.
+        // Defaults to the current viewport, which is only right when components are drawn in window pixels;
+        // set it when the manager is drawn under a camera or a transform. clearCullRect() goes back to the viewport.
+        void setCullRect(const ofRectangle& rect);
+        void clearCullRect();
+        ofRectangle getCullRect();
+        
+        // Record the duration of onUpdate(), onDraw(), event handlers and timers of each component,
+        // keeping the last capacity calls. Needs OFX_COMPONENT_PROFILING defined, the calls aren't timed without it.
+        // Enabling again starts a new recording. Disabled by default.
+        void setProfilingEnabled(bool enabled, size_t capacity = 1 << 16);
+        bool getProfilingEnabled();
+        // Chrome trace JSON of the recorded calls, for chrome://tracing or https://ui.perfetto.dev. Path is relative to data.
+        bool saveProfileTrace(const string& path);
+        // table of calls, total/avg/max time per class and callback, empty while disabled
+        string getProfileReport();
+        
+        // Run onUpdate() of subtrees marked with setThreadSafeUpdate(true) on a thread pool,
+        // before the usual update of the rest. numThreads includes the main thread, 0 for all hardware threads.
+        // With the transform store enabled, transform changes made in the phase reach the store after all tasks:
+        // global matrices read in the phase still have the transform of the frame start.
+        // Disabled by default.
+        void setParallelUpdateEnabled(bool enabled, int numThreads = 0);
+        bool getParallelUpdateEnabled();
+        
+        // Spread the teardown of destroyed components over several frames.
+        // Each update() stops after the given time [ms] or number of components, 0 means no limit.
+        // Destroyed components are skipped by update/draw/events until they are removed.
+        void setDestroyBudget(float maxMillis, int maxComponents = 0);
+        // remove all destroyed components now, regardless of the budget
+        void flushDestroyedObjects();
+        size_t getNumPendingDestroy();
+        
         static shared_ptr<ofxComponentManager> singleton;
     private:
         void checkMostTopComponent();
-        void removeDestroyedObjects();
+        bool isHitTestable(ofxComponentBase* c);
+        // children of c can't be hit at the mouse position
+        bool isClippedOut(ofxComponentBase* c);
+        unique_ptr<ofxComponentSpatialIndex> index;
+        vector<ofxComponentBase*> hitCandidates;
+        unique_ptr<ofxComponentTransformStore> transforms;
+        unique_ptr<ofxComponentInputRouter> router;
+        unique_ptr<ofxComponentParallelUpdater> updater;
+        unique_ptr<ofxComponentRenderList> renderList;
+        unique_ptr<ofxComponentFboPool> fbos;
+        unique_ptr<ofxComponentProfiler> profiler;
+        vector<ofxComponentBase*> parallelRoots;
+        void updateParallelSubtrees();
+        void removeDestroyedObjects(bool force);
+        float destroyBudgetMillis = 0;
+        int destroyBudgetCount = 0;
+        ofRectangle userCullRect;
+        bool hasUserCullRect = false;
 	};
 }
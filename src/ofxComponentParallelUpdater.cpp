@@ -0,0 +1,203 @@
+#include "ofxComponentParallelUpdater.h"
+#include "ofxComponentBase.h"
+
+using namespace ofxComponent;
+
+namespace {
+    // index of the queue of this thread, -1 outside of tasks
+    thread_local int currentQueue = -1;
+    thread_local const ofxComponentParallelUpdater* currentUpdater = nullptr;
+}
+
+ofxComponentParallelUpdater::ofxComponentParallelUpdater(int numThreads)
+: pending(0), available(0), idle(0)
+{
+    if (numThreads <= 0) numThreads = MAX(1, (int)thread::hardware_concurrency());
+    
+    for (int i = 0; i < numThreads; ++i) {
+        queues.push_back(make_unique<Queue>());
+    }
+    // queue 0 is for the calling thread
+    for (int i = 1; i < numThreads; ++i) {
+        threads.push_back(thread(&ofxComponentParallelUpdater::workerLoop, this, i));
+    }
+}
+
+ofxComponentParallelUpdater::~ofxComponentParallelUpdater() {
+    {
+        lock_guard<mutex> lock(wakeMutex);
+        quit = true;
+    }
+    wakeCondition.notify_all();
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+void ofxComponentParallelUpdater::run(const vector<ofxComponentBase*>& roots) {
+    if (roots.empty()) return;
+    
+    // spread the roots, the rest is balanced by stealing
+    pending = roots.size();
+    available = roots.size();
+    for (size_t i = 0; i < roots.size(); ++i) {
+        auto& q = *queues[i % queues.size()];
+        lock_guard<mutex> lock(q.m);
+        q.tasks.push_back(roots[i]);
+    }
+    
+    {
+        lock_guard<mutex> lock(wakeMutex);
+        ++generation;
+        runningWorkers = threads.size();
+    }
+    wakeCondition.notify_all();
+    
+    currentQueue = 0;
+    currentUpdater = this;
+    work(0);
+    currentQueue = -1;
+    currentUpdater = nullptr;
+    
+    // barrier
+    {
+        unique_lock<mutex> lock(wakeMutex);
+        doneCondition.wait(lock, [this] { return runningWorkers == 0; });
+    }
+    
+    applyDeferred();
+    
+    if (error) {
+        exception_ptr e = error;
+        error = nullptr;
+        rethrow_exception(e);
+    }
+}
+
+void ofxComponentParallelUpdater::spawn(ofxComponentBase* c) {
+    ++pending;
+    {
+        auto& q = *queues[currentQueue];
+        lock_guard<mutex> lock(q.m);
+        q.tasks.push_back(c);
+    }
+    ++available;
+    notifyIdle(false);
+}
+
+bool ofxComponentParallelUpdater::isInTask() const {
+    return currentUpdater == this;
+}
+
+void ofxComponentParallelUpdater::defer(function<void()> func) {
+    lock_guard<mutex> lock(deferMutex);
+    deferredCalls.push_back(std::move(func));
+}
+
+void ofxComponentParallelUpdater::deferTransformChanged(ofxComponentBase* c) {
+    lock_guard<mutex> lock(deferMutex);
+    deferredTransforms.push_back(c);
+}
+
+void ofxComponentParallelUpdater::workerLoop(int index) {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lock(wakeMutex);
+            wakeCondition.wait(lock, [&] { return quit || generation != seen; });
+            if (quit) return;
+            seen = generation;
+        }
+        
+        currentQueue = index;
+        currentUpdater = this;
+        work(index);
+        currentQueue = -1;
+        currentUpdater = nullptr;
+        
+        {
+            lock_guard<mutex> lock(wakeMutex);
+            --runningWorkers;
+        }
+        doneCondition.notify_all();
+    }
+}
+
+void ofxComponentParallelUpdater::work(int index) {
+    ofxComponentBase* c;
+    int misses = 0;
+    while (pending > 0) {
+        if (pop(index, c)) {
+            misses = 0;
+            try {
+                c->updateParallel(*this);
+            }
+            catch (...) {
+                // rethrown by run() on the calling thread, the others still finish their tasks
+                lock_guard<mutex> lock(deferMutex);
+                if (!error) error = current_exception();
+            }
+            if (--pending == 0) notifyIdle(true);
+        }
+        else if (++misses < spinCount) {
+            this_thread::yield();
+        }
+        else {
+            // the others are busy with their last tasks, don't burn a core
+            unique_lock<mutex> lock(idleMutex);
+            ++idle;
+            idleCondition.wait(lock, [this] { return pending == 0 || available > 0; });
+            --idle;
+            misses = 0;
+        }
+    }
+}
+
+void ofxComponentParallelUpdater::notifyIdle(bool all) {
+    // idle is raised before the sleeping thread checks, so either it sees the change or is woken here
+    if (idle == 0) return;
+    lock_guard<mutex> lock(idleMutex);
+    if (all) idleCondition.notify_all();
+    else idleCondition.notify_one();
+}
+
+bool ofxComponentParallelUpdater::pop(int index, ofxComponentBase*& c) {
+    // own queue, newest first (deepest, still in cache)
+    {
+        auto& q = *queues[index];
+        lock_guard<mutex> lock(q.m);
+        if (!q.tasks.empty()) {
+            c = q.tasks.back();
+            q.tasks.pop_back();
+            --available;
+            return true;
+        }
+    }
+    // steal the oldest (biggest) from the others
+    for (size_t i = 1; i < queues.size(); ++i) {
+        auto& q = *queues[(index + i) % queues.size()];
+        lock_guard<mutex> lock(q.m);
+        if (!q.tasks.empty()) {
+            c = q.tasks.front();
+            q.tasks.pop_front();
+            --available;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ofxComponentParallelUpdater::applyDeferred() {
+    // transforms first, the calls may remove components
+    for (auto c : deferredTransforms) {
+        c->transformChanged();
+    }
+    deferredTransforms.clear();
+    
+    // not in a task anymore, so these run directly
+    vector<function<void()> > calls;
+    calls.swap(deferredCalls);
+    for (auto& f : calls) {
+        f();
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "ofMain.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+
+namespace ofxComponent {
+	class ofxComponentBase;
+
+	// Work stealing thread pool for the parallel update phase.
+	// Each thread has its own queue of subtrees, takes work from the back of it
+	// and steals from the front of the others when it runs out.
+	// The calling (main) thread works too, run() returns when all subtrees are done.
+	// Tree changes made by the tasks are queued and applied after that, on the calling thread.
+	class ofxComponentParallelUpdater {
+	public:
+		// numThreads includes the calling thread, 0 for the number of hardware threads
+		ofxComponentParallelUpdater(int numThreads = 0);
+		~ofxComponentParallelUpdater();
+
+		// onUpdate() of the subtrees in parallel, then the deferred changes.
+		// The first exception thrown by a task is rethrown here, after all tasks are done.
+		void run(const vector<ofxComponentBase*>& roots);
+
+		// from a task: update c as another task, maybe on another thread
+		void spawn(ofxComponentBase* c);
+
+		// the current thread is running a task of this pool
+		bool isInTask() const;
+
+		// from a task: call func after all tasks are done
+		void defer(function<void()> func);
+		// from a task: c changed its transform, tell the shared structures after the tasks
+		void deferTransformChanged(ofxComponentBase* c);
+		// for short non thread safe sections in tasks
+		mutex& getMutex() { return deferMutex; }
+
+		int getNumThreads() const { return queues.size(); }
+
+	private:
+		struct Queue {
+			mutex m;
+			deque<ofxComponentBase*> tasks;
+		};
+
+		void workerLoop(int index);
+		void work(int index);
+		bool pop(int index, ofxComponentBase*& c);
+		void notifyIdle(bool all);
+		void applyDeferred();
+
+		vector<unique_ptr<Queue> > queues;
+		vector<thread> threads;
+		atomic<int> pending;
+		// tasks in the queues, not taken yet
+		atomic<int> available;
+
+		// threads that found nothing to steal spin a little, then sleep until a task is spawned or all are done
+		static const int spinCount = 64;
+		mutex idleMutex;
+		condition_variable idleCondition;
+		atomic<int> idle;
+
+		mutex wakeMutex;
+		condition_variable wakeCondition, doneCondition;
+		uint64_t generation = 0;
+		int runningWorkers = 0;
+		bool quit = false;
+
+		mutex deferMutex;
+		vector<function<void()> > deferredCalls;
+		vector<ofxComponentBase*> deferredTransforms;
+		exception_ptr error;
+	};
+}
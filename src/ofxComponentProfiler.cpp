@@ -0,0 +1,170 @@
+#include "ofxComponentProfiler.h"
+#include "ofxComponentBase.h"
+#include <chrono>
+#if defined(__GNUG__) && defined(OFX_COMPONENT_RTTI)
+#include <cxxabi.h>
+#endif
+
+using namespace ofxComponent;
+
+ofxComponentProfiler* ofxComponentProfiler::active = nullptr;
+
+namespace {
+    // small ids for the trace, in the order threads record first
+    std::atomic<unsigned short> threadCounter(0);
+    unsigned short getThreadId() {
+        thread_local unsigned short id = threadCounter++;
+        return id;
+    }
+
+    // for a JSON string value
+    string escapeJson(const string& text) {
+        string result;
+        result.reserve(text.size());
+        for (unsigned char c : text) {
+            switch (c) {
+                case '"': result += "\\\""; break;
+                case '\\': result += "\\\\"; break;
+                case '\n': result += "\\n"; break;
+                case '\r': result += "\\r"; break;
+                case '\t': result += "\\t"; break;
+                default:
+                    if (c < 0x20) {
+                        char buf[8];
+                        snprintf(buf, sizeof(buf), "\\u%04x", c);
+                        result += buf;
+                    }
+                    else {
+                        result += (char)c;
+                    }
+            }
+        }
+        return result;
+    }
+}
+
+ofxComponentProfiler::ofxComponentProfiler(size_t capacity)
+: samples(MAX((size_t)1, capacity))
+, written(0)
+, origin(now())
+{
+}
+
+void ofxComponentProfiler::record(const ofxComponentBase* component, ProfileEvent event, uint64_t start, uint64_t end) {
+    Sample s;
+    s.component = component;
+#ifdef OFX_COMPONENT_RTTI
+    s.typeName = component ? typeid(*component).name() : "";
+#else
+    // closest class with OFX_COMPONENT_TYPE()
+    s.typeName = component ? component->getType().getName() : "";
+#endif
+    s.start = start - origin;
+    s.duration = end - start;
+    s.event = event;
+    s.thread = getThreadId();
+
+    // overwrites the oldest one when full
+    uint64_t i = written.fetch_add(1, std::memory_order_relaxed);
+    samples[i % samples.size()] = s;
+}
+
+void ofxComponentProfiler::clear() {
+    written = 0;
+}
+
+size_t ofxComponentProfiler::size() const {
+    return (size_t)MIN(written.load(), (uint64_t)samples.size());
+}
+
+bool ofxComponentProfiler::saveChromeTrace(const string& path) const {
+    ofstream file(ofToDataPath(path, true));
+    if (!file) {
+        ofLogWarning("ofxComponentProfiler") << "saveChromeTrace(): can't open " << path;
+        return false;
+    }
+
+    // class names are demangled and escaped once
+    map<const char*, string> names;
+
+    file << "{\"traceEvents\":[";
+    bool first = true;
+    forEach([&](const Sample& s) {
+        auto itr = names.find(s.typeName);
+        if (itr == names.end()) itr = names.emplace(s.typeName, escapeJson(demangle(s.typeName))).first;
+
+        if (!first) file << ",";
+        first = false;
+        // microseconds
+        file << "\n{\"name\":\"" << itr->second << "::" << getEventName(s.event) << "\""
+            << ",\"cat\":\"" << getEventName(s.event) << "\""
+            << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << s.thread
+            << ",\"ts\":" << (s.start / 1000) << "." << ofToString(s.start % 1000, 3, '0')
+            << ",\"dur\":" << (s.duration / 1000) << "." << ofToString(s.duration % 1000, 3, '0')
+            << ",\"args\":{\"component\":\"" << s.component << "\"}}";
+    });
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return true;
+}
+
+string ofxComponentProfiler::getReport() const {
+    struct Row {
+        uint64_t calls = 0, total = 0, max = 0;
+    };
+    map<pair<const char*, ProfileEvent>, Row> rows;
+    forEach([&](const Sample& s) {
+        auto& r = rows[make_pair(s.typeName, s.event)];
+        ++r.calls;
+        r.total += s.duration;
+        r.max = MAX(r.max, s.duration);
+    });
+
+    vector<pair<pair<const char*, ProfileEvent>, Row> > sorted(rows.begin(), rows.end());
+    sort(sorted.begin(), sorted.end(), [](const pair<pair<const char*, ProfileEvent>, Row>& a, const pair<pair<const char*, ProfileEvent>, Row>& b) {
+        return a.second.total > b.second.total;
+    });
+
+    stringstream ss;
+    ss << std::left << setw(40) << "class" << setw(24) << "callback" << std::right
+        << setw(10) << "calls" << setw(12) << "total ms" << setw(12) << "avg us" << setw(12) << "max us" << "\n";
+    ss << std::fixed << std::setprecision(3);
+    for (auto& r : sorted) {
+        ss << std::left << setw(40) << demangle(r.first.first) << setw(24) << getEventName(r.first.second) << std::right
+            << setw(10) << r.second.calls
+            << setw(12) << r.second.total / 1e6
+            << setw(12) << r.second.total / 1e3 / r.second.calls
+            << setw(12) << r.second.max / 1e3 << "\n";
+    }
+    return ss.str();
+}
+
+uint64_t ofxComponentProfiler::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* ofxComponentProfiler::getEventName(ProfileEvent event) {
+    switch (event) {
+    case ProfileUpdate: return "onUpdate";
+    case ProfilePostUpdate: return "postUpdate";
+    case ProfileDraw: return "onDraw";
+    case ProfilePostDraw: return "postDraw";
+    case ProfileInput: return "input";
+    case ProfileTimer: return "timer";
+    case ProfileRemoveDestroyed: return "removeDestroyedObjects";
+    default: return "";
+    }
+}
+
+string ofxComponentProfiler::demangle(const char* name) {
+#if defined(__GNUG__) && defined(OFX_COMPONENT_RTTI)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status == 0 && demangled) {
+        string result(demangled);
+        free(demangled);
+        return result;
+    }
+#endif
+    return name;
+}
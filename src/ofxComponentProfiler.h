@@ -0,0 +1,100 @@
+#pragma once
+#include "ofMain.h"
+#include <atomic>
+
+// Define OFX_COMPONENT_PROFILING for the whole project to time the callbacks of every component.
+// Without it OFX_COMPONENT_PROFILE() is only the statement, and nothing is recorded.
+#ifdef OFX_COMPONENT_PROFILING
+#define OFX_COMPONENT_PROFILE(component, event, ...) \
+	do { ofxComponent::ofxComponentProfileScope ofxComponentProfileScope_(component, event); __VA_ARGS__; } while (0)
+#else
+#define OFX_COMPONENT_PROFILE(component, event, ...) \
+	do { __VA_ARGS__; } while (0)
+#endif
+
+namespace ofxComponent {
+	class ofxComponentBase;
+
+	enum ProfileEvent : unsigned char {
+		ProfileUpdate,
+		ProfilePostUpdate,
+		ProfileDraw,
+		ProfilePostDraw,
+		ProfileInput,
+		ProfileTimer,
+		ProfileRemoveDestroyed
+	};
+
+	// Ring buffer of the last callbacks of components, with their class and duration.
+	// Recording is lock free, so onUpdate() of the parallel update can record too.
+	// Read it (save, report) only outside of update/draw.
+	class ofxComponentProfiler {
+	public:
+		ofxComponentProfiler(size_t capacity);
+
+		void record(const ofxComponentBase* component, ProfileEvent event, uint64_t start, uint64_t end);
+		void clear();
+		// recorded calls, at most the capacity
+		size_t size() const;
+
+		// Chrome trace event format, open in chrome://tracing or https://ui.perfetto.dev
+		bool saveChromeTrace(const string& path) const;
+		// calls, total, average and max time per class and callback, most expensive first
+		string getReport() const;
+
+		// nanoseconds
+		static uint64_t now();
+		static const char* getEventName(ProfileEvent event);
+
+		// Set by ofxComponentManager, nullptr when disabled
+		static ofxComponentProfiler* active;
+
+	private:
+		struct Sample {
+			const ofxComponentBase* component;
+			const char* typeName; // mangled from typeid, or ofxComponentTypeInfo name without RTTI
+			uint64_t start, duration;
+			ProfileEvent event;
+			unsigned short thread;
+		};
+
+		// oldest first
+		template<typename F>
+		void forEach(F&& f) const;
+		static string demangle(const char* name);
+
+		vector<Sample> samples;
+		std::atomic<uint64_t> written;
+		uint64_t origin;
+	};
+
+	// Times its lifetime, for OFX_COMPONENT_PROFILE()
+	class ofxComponentProfileScope {
+	public:
+		ofxComponentProfileScope(const ofxComponentBase* _component, ProfileEvent _event)
+			: component(_component), event(_event), profiler(ofxComponentProfiler::active) {
+			if (profiler) start = ofxComponentProfiler::now();
+		}
+		~ofxComponentProfileScope() {
+			// disabled by the callback
+			if (profiler && profiler == ofxComponentProfiler::active) {
+				profiler->record(component, event, start, ofxComponentProfiler::now());
+			}
+		}
+
+	private:
+		const ofxComponentBase* component;
+		ProfileEvent event;
+		ofxComponentProfiler* profiler;
+		uint64_t start = 0;
+	};
+
+	template<typename F>
+	void ofxComponentProfiler::forEach(F&& f) const {
+		uint64_t end = written.load();
+		uint64_t count = MIN(end, (uint64_t)samples.size());
+		for (uint64_t i = end - count; i < end; ++i) {
+			f(samples[i % samples.size()]);
+		}
+	}
+}
@@ -0,0 +1,124 @@
+#include "ofxComponentRegistry.h"
+
+using namespace ofxComponent;
+
+ofxComponentRegistry::Handle ofxComponentRegistry::insert(shared_ptr<ofxComponentBase> c) {
+    uint32_t index;
+    if (firstFree >= 0) {
+        index = firstFree;
+        firstFree = slots[index].nextFree;
+    }
+    else {
+        index = slots.size();
+        slots.push_back(Slot());
+    }
+
+    auto& slot = slots[index];
+    slot.component = c.get();
+    slot.denseIndex = dense.size();
+    slot.nextFree = -1;
+
+    dense.push_back(c);
+    denseToSlot.push_back(index);
+    insertType(index);
+
+    Handle h;
+    h.index = index;
+    h.generation = slot.generation;
+    return h;
+}
+
+bool ofxComponentRegistry::remove(Handle h) {
+    if (get(h) == nullptr) return false;
+    auto& slot = slots[h.index];
+    removeType(h.index);
+
+    // move the last one into the hole
+    uint32_t hole = slot.denseIndex;
+    uint32_t last = dense.size() - 1;
+    if (hole != last) {
+        dense[hole] = std::move(dense[last]);
+        denseToSlot[hole] = denseToSlot[last];
+        slots[denseToSlot[hole]].denseIndex = hole;
+    }
+
+    slot.component = nullptr;
+    if (++slot.generation == 0) slot.generation = 1;
+    slot.nextFree = firstFree;
+    firstFree = h.index;
+
+    // may delete the component, so do it last
+    denseToSlot.pop_back();
+    dense.pop_back();
+    return true;
+}
+
+ofxComponentBase* ofxComponentRegistry::get(Handle h) const {
+    if (h.generation == 0 || h.index >= slots.size()) return nullptr;
+    auto& slot = slots[h.index];
+    if (slot.generation != h.generation) return nullptr;
+    return slot.component;
+}
+
+const vector<const ofxComponentRegistry::TypeList*>& ofxComponentRegistry::getTypeLists(const ofxComponentTypeInfo& type, bool includeSubclasses) {
+    auto key = make_pair(&type, includeSubclasses);
+    auto itr = queries.find(key);
+    if (itr != queries.end()) return itr->second.lists;
+    
+    // first time, test the classes there are now. Later ones are tested when they appear
+    Query q = { &type, includeSubclasses, {} };
+    for (auto& t : types) {
+        if (q.matches(*t.first)) q.lists.push_back(&t.second.components);
+    }
+    return queries.emplace(key, std::move(q)).first->second.lists;
+}
+
+void ofxComponentRegistry::insertType(uint32_t slotIndex) {
+    auto& slot = slots[slotIndex];
+    auto type = &slot.component->getType();
+    
+    auto itr = types.find(type);
+    bool added = itr == types.end();
+    if (added) itr = types.emplace(type, TypeEntry()).first;
+    
+    auto& entry = itr->second;
+    slot.typeIndex = entry.components.size();
+    entry.components.push_back(slot.component);
+    entry.slots.push_back(slotIndex);
+    
+    if (!added) return;
+    for (auto& q : queries) {
+        if (q.second.matches(*type)) q.second.lists.push_back(&entry.components);
+    }
+}
+
+void ofxComponentRegistry::removeType(uint32_t slotIndex) {
+    auto& slot = slots[slotIndex];
+    auto itr = types.find(&slot.component->getType());
+    if (itr == types.end()) return;
+    auto& entry = itr->second;
+    
+    // move the last one into the hole
+    uint32_t hole = slot.typeIndex;
+    uint32_t last = entry.components.size() - 1;
+    if (hole != last) {
+        entry.components[hole] = entry.components[last];
+        entry.slots[hole] = entry.slots[last];
+        slots[entry.slots[hole]].typeIndex = hole;
+    }
+    entry.components.pop_back();
+    entry.slots.pop_back();
+    if (!entry.components.empty()) return;
+    
+    // no one of this class anymore, it is tested again if one comes back
+    for (auto& q : queries) {
+        auto& lists = q.second.lists;
+        lists.erase(std::remove(lists.begin(), lists.end(), &entry.components), lists.end());
+    }
+    types.erase(itr);
+}
+
+bool ofxComponentRegistry::Query::matches(const ofxComponentTypeInfo& entryType) const {
+    if (&entryType == type) return true;
+    return includeSubclasses && entryType.isA(*type);
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "ofMain.h"
+#include "ofxComponentBase.h"
+
+namespace ofxComponent {
+	// Slot map of all started components.
+	// Insert and remove are O(1), components are kept densely for iteration,
+	// and each one gets a generational handle that stops resolving once it is removed.
+	// Components are also listed per class, so all components of a class are found without casting each one.
+	class ofxComponentRegistry {
+	public:
+		typedef ofxComponentBase::ComponentHandle Handle;
+		typedef vector<shared_ptr<ofxComponentBase> > List;
+		typedef vector<ofxComponentBase*> TypeList;
+
+		Handle insert(shared_ptr<ofxComponentBase> c);
+		// returns false if h was already removed
+		bool remove(Handle h);
+		// nullptr once removed
+		ofxComponentBase* get(Handle h) const;
+
+		size_t size() const { return dense.size(); }
+		bool empty() const { return dense.empty(); }
+
+		// dense iteration, order changes when components are removed
+		List::iterator begin() { return dense.begin(); }
+		List::iterator end() { return dense.end(); }
+		List::const_iterator begin() const { return dense.begin(); }
+		List::const_iterator end() const { return dense.end(); }
+
+		// Lists of the classes matching type: type only, or with includeSubclasses every class derived from it.
+		// Classes are matched once per query, not per component. The result is kept up to date as classes come and go.
+		const vector<const TypeList*>& getTypeLists(const ofxComponentTypeInfo& type, bool includeSubclasses);
+
+	private:
+		struct Slot {
+			ofxComponentBase* component = nullptr;
+			uint32_t generation = 1;
+			uint32_t denseIndex = 0;
+			uint32_t typeIndex = 0; // in components of its TypeEntry
+			int nextFree = -1;
+		};
+		vector<Slot> slots;
+		int firstFree = -1;
+
+		List dense;
+		vector<uint32_t> denseToSlot;
+
+		// components of one class, only while there is one
+		struct TypeEntry {
+			TypeList components;
+			vector<uint32_t> slots;
+		};
+		unordered_map<const ofxComponentTypeInfo*, TypeEntry> types;
+		void insertType(uint32_t slotIndex);
+		void removeType(uint32_t slotIndex);
+
+		struct Query {
+			const ofxComponentTypeInfo* type;
+			bool includeSubclasses;
+			vector<const TypeList*> lists;
+			bool matches(const ofxComponentTypeInfo& entryType) const;
+		};
+		map<pair<const ofxComponentTypeInfo*, bool>, Query> queries;
+	};
+}
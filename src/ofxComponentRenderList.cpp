@@ -0,0 +1,147 @@
+#include "ofxComponentRenderList.h"
+#include "ofxComponentBase.h"
+#include "ofxComponentProfiler.h"
+
+using namespace ofxComponent;
+
+ofxComponentRenderList::ofxComponentRenderList(ofxComponentBase* _root)
+: root(_root)
+{
+}
+
+void ofxComponentRenderList::draw(ofEventArgs& args) {
+    if (isStale()) rebuild();
+    
+    ++frameStamp;
+    ofPushMatrix();
+    ofMatrix4x4 base = ofGetCurrentMatrix(OF_MATRIX_MODELVIEW);
+    
+    size_t i = 0;
+    while (i < items.size()) {
+        Item item = items[i++];
+        if (item.type == Cull) {
+            if (!item.component->isInView()) i = item.end;
+            continue;
+        }
+        if (!drawItem(item, base, args)) continue;
+        
+        if (isInvalid()) {
+            // changed by a draw callback, continue with what isn't drawn yet
+            rebuild();
+            i = 0;
+        }
+    }
+    
+    ofPopMatrix();
+}
+
+size_t ofxComponentRenderList::size() {
+    if (isStale()) rebuild();
+    return items.size();
+}
+
+bool ofxComponentRenderList::isStale() {
+    return isInvalid() || builtDrawInterestVersion != ofxComponentBase::drawInterestVersion;
+}
+
+bool ofxComponentRenderList::isInvalid() {
+    return !built ||
+        builtStructureVersion != ofxComponentBase::structureVersion ||
+        builtDrawVersion != ofxComponentBase::drawVersion;
+}
+
+void ofxComponentRenderList::rebuild() {
+    ++numRebuilds;
+    // start() may add components, so start them all first
+    bool started;
+    do {
+        started = false;
+        unsigned int version = ofxComponentBase::structureVersion;
+        if (root->needStartExec) root->start();
+        root->walkDescendants([&](ofxComponentBase& c) {
+            if (c.needStartExec) {
+                c.start();
+                started = true;
+            }
+            return c.isActive && !c.destroyed;
+        });
+        if (version != ofxComponentBase::structureVersion) started = true;
+    } while (started);
+    
+    items.clear();
+    walkStack.clear();
+    const size_t npos = (size_t)-1;
+    walkStack.push_back({ root, false, npos });
+    while (!walkStack.empty()) {
+        auto e = walkStack.back();
+        walkStack.pop_back();
+        auto c = e.component;
+        
+        if (e.post) {
+            if (c->drawsPostDraw) items.push_back({ c, PostDraw });
+            if (e.cullItem != npos) items[e.cullItem].end = items.size();
+            continue;
+        }
+        
+        if (!c->isActive || c->destroyed) continue;
+        
+        if (c->constrain || c->cacheAsBitmap) {
+            items.push_back({ c, Subtree });
+            continue;
+        }
+        
+        auto children = c->getChildrenView();
+        size_t cullItem = npos;
+        if (ofxComponentBase::culling && !c->childrenDrawOutside && children.size() > 0) {
+            cullItem = items.size();
+            items.push_back({ c, Cull });
+        }
+        if (c->drawsOnDraw) items.push_back({ c, OnDraw });
+        if (c->drawsPostDraw || cullItem != npos) walkStack.push_back({ c, true, cullItem });
+        for (size_t i = children.size(); i > 0; --i) {
+            walkStack.push_back({ children[i - 1], false, npos });
+        }
+    }
+    
+    built = true;
+    builtStructureVersion = ofxComponentBase::structureVersion;
+    builtDrawVersion = ofxComponentBase::drawVersion;
+    builtDrawInterestVersion = ofxComponentBase::drawInterestVersion;
+}
+
+bool ofxComponentRenderList::drawItem(const Item& item, const ofMatrix4x4& base, ofEventArgs& args) {
+    auto c = item.component;
+    
+    // drawn before the list was rebuilt in this frame
+    unsigned int& stamp = item.type == PostDraw ? c->postDrawStamp : c->drawStamp;
+    if (stamp == frameStamp) return false;
+    stamp = frameStamp;
+    
+    // this one is out of view, its children are checked by themselves
+    if (ofxComponentBase::culling && item.type != Subtree && !c->isInView()) return true;
+    
+    switch (item.type) {
+    case OnDraw:
+        ofLoadMatrix(c->getGlobalMatrix() * base);
+        ofPushStyle();
+        OFX_COMPONENT_PROFILE(c, ProfileDraw, c->onDraw());
+        ofPopStyle();
+        break;
+    case PostDraw:
+        ofLoadMatrix(c->getGlobalMatrix() * base);
+        ofPushStyle();
+        OFX_COMPONENT_PROFILE(c, ProfilePostDraw, c->postDraw());
+        ofPopStyle();
+        break;
+    case Subtree: {
+        // draw() applies the local matrix itself
+        auto p = c->getParent();
+        ofLoadMatrix(p ? p->getGlobalMatrix() * base : base);
+        c->draw(args);
+        break;
+    }
+    case Cull:
+        break;
+    }
+    return true;
+}
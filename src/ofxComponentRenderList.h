@@ -0,0 +1,57 @@
+#pragma once
+#include "ofMain.h"
+
+namespace ofxComponent {
+	class ofxComponentBase;
+
+	// Flat list of the draw calls of the tree in paint order.
+	// Each call loads the cached global matrix of its component instead of
+	// pushing and multiplying matrices down the tree, and components that don't
+	// override onDraw()/postDraw() are not in the list at all.
+	// Rebuilt only when the structure, order, active state, constrain, cache or culling changes.
+	class ofxComponentRenderList {
+	public:
+		ofxComponentRenderList(ofxComponentBase* root);
+
+		void draw(ofEventArgs& args);
+
+		size_t size();
+		// times the list was built, it should only grow when the tree changes
+		unsigned int getNumRebuilds() const { return numRebuilds; }
+
+	private:
+		enum ItemType {
+			OnDraw,
+			PostDraw,
+			Subtree, // constrained or cached, drawn recursively into its fbo
+			Cull     // skip to end when the component is out of view
+		};
+		struct Item {
+			ofxComponentBase* component;
+			ItemType type;
+			size_t end = 0; // Cull: index after the items of the subtree
+		};
+		struct WalkEntry {
+			ofxComponentBase* component;
+			bool post;
+			size_t cullItem; // npos if none
+		};
+
+		bool isStale();
+		// changes that make the current pass draw the wrong things, draw interests only drop or add calls
+		bool isInvalid();
+		void rebuild();
+		bool drawItem(const Item& item, const ofMatrix4x4& base, ofEventArgs& args);
+
+		ofxComponentBase* root;
+		bool built = false;
+		unsigned int builtStructureVersion = 0;
+		unsigned int builtDrawVersion = 0;
+		unsigned int builtDrawInterestVersion = 0;
+		unsigned int frameStamp = 0;
+		unsigned int numRebuilds = 0;
+
+		vector<Item> items;
+		vector<WalkEntry> walkStack;
+	};
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "ofMain.h"
+
+namespace ofxComponent {
+	// void() callable stored in a fixed inline buffer, like a std::function
+	// that does not allocate for small lambdas.
+	// Callables bigger than BufferSize are still accepted and kept on the heap.
+	template<size_t BufferSize>
+	class ofxComponentSmallFunction {
+	public:
+		ofxComponentSmallFunction() {}
+		~ofxComponentSmallFunction() { reset(); }
+
+		ofxComponentSmallFunction(const ofxComponentSmallFunction&) = delete;
+		ofxComponentSmallFunction& operator=(const ofxComponentSmallFunction&) = delete;
+
+		// an empty std::function stays empty
+		template<typename F>
+		void assign(F&& f) {
+			typedef typename decay<F>::type Fn;
+			reset();
+			if constexpr (is_same<Fn, function<void()> >::value) {
+				if (!f) return;
+			}
+			if constexpr (sizeof(Fn) <= BufferSize && alignof(Fn) <= alignof(max_align_t)) {
+				new (buffer) Fn(std::forward<F>(f));
+				invoker = [](void* p) { (*static_cast<Fn*>(p))(); };
+				destroyer = [](void* p) { static_cast<Fn*>(p)->~Fn(); };
+			}
+			else {
+				*reinterpret_cast<Fn**>(buffer) = new Fn(std::forward<F>(f));
+				invoker = [](void* p) { (**static_cast<Fn**>(p))(); };
+				destroyer = [](void* p) { delete *static_cast<Fn**>(p); };
+			}
+		}
+
+		void reset() {
+			if (destroyer) destroyer(buffer);
+			invoker = nullptr;
+			destroyer = nullptr;
+		}
+
+		void operator()() { invoker(buffer); }
+		explicit operator bool() const { return invoker != nullptr; }
+
+	private:
+		alignas(max_align_t) unsigned char buffer[BufferSize];
+		void (*invoker)(void*) = nullptr;
+		void (*destroyer)(void*) = nullptr;
+	};
+}
@@ -0,0 +1,231 @@
+#include "ofxComponentSpatialIndex.h"
+#include "ofxComponentBase.h"
+
+using namespace ofxComponent;
+
+ofxComponentSpatialIndex::ofxComponentSpatialIndex(ofxComponentBase* _root, ofRectangle bounds)
+: root(_root)
+{
+    Node rootNode;
+    rootNode.bounds = bounds;
+    nodes.push_back(rootNode);
+
+    // build everything on the first query
+    markDirty(root);
+}
+
+void ofxComponentSpatialIndex::markDirty(ofxComponentBase* c) {
+    dirty.insert(c);
+}
+
+void ofxComponentSpatialIndex::markOrderDirty() {
+    orderDirty = true;
+}
+
+void ofxComponentSpatialIndex::removeSubtree(ofxComponentBase* c) {
+    walkStack.clear();
+    walkStack.push_back(c);
+    while (!walkStack.empty()) {
+        auto n = walkStack.back();
+        walkStack.pop_back();
+        forget(n);
+        for (auto cc : n->getChildrenView()) {
+            walkStack.push_back(cc);
+        }
+    }
+}
+
+void ofxComponentSpatialIndex::remove(ofxComponentBase* c) {
+    dirty.erase(c);
+    forget(c);
+}
+
+void ofxComponentSpatialIndex::forget(ofxComponentBase* c) {
+    auto itr = entries.find(c);
+    if (itr == entries.end()) return;
+    removeFromNode(itr->second);
+    entries.erase(itr);
+}
+
+void ofxComponentSpatialIndex::query(ofVec2f p, vector<ofxComponentBase*>& result) {
+    result.clear();
+    refresh();
+
+    int n = 0;
+    while (n >= 0) {
+        auto& node = nodes[n];
+        for (auto c : node.items) {
+            if (entries[c].bounds.inside(p)) {
+                result.push_back(c);
+            }
+        }
+
+        if (node.firstChild < 0 || !node.bounds.inside(p)) break;
+
+        ofVec2f mid = node.bounds.getCenter();
+        int q = (p.x < mid.x ? 0 : 1) + (p.y < mid.y ? 0 : 2);
+        n = node.firstChild + q;
+    }
+
+    // frontmost first
+    sort(result.begin(), result.end(), [this](ofxComponentBase* a, ofxComponentBase* b) {
+        return entries[a].order > entries[b].order;
+    });
+}
+
+void ofxComponentSpatialIndex::refresh() {
+    if (!dirty.empty()) {
+        for (auto d : dirty) {
+            if (!isUnderRoot(d)) {
+                // detached before we noticed
+                removeSubtree(d);
+                continue;
+            }
+
+            walkStack.clear();
+            walkStack.push_back(d);
+            while (!walkStack.empty()) {
+                auto n = walkStack.back();
+                walkStack.pop_back();
+                // new entries need a paint order, moved ones keep theirs
+                if (n != root && updateEntry(n)) orderDirty = true;
+                for (auto cc : n->getChildrenView()) {
+                    walkStack.push_back(cc);
+                }
+            }
+        }
+        dirty.clear();
+    }
+
+    if (orderDirty) {
+        // number all nodes in pre-order, same as the draw order
+        unsigned int order = 0;
+        walkStack.clear();
+        walkStack.push_back(root);
+        while (!walkStack.empty()) {
+            auto n = walkStack.back();
+            walkStack.pop_back();
+            auto itr = entries.find(n);
+            if (itr != entries.end()) {
+                itr->second.order = order;
+            }
+            ++order;
+            auto children = n->getChildrenView();
+            for (size_t i = children.size(); i > 0; --i) {
+                walkStack.push_back(children[i - 1]);
+            }
+        }
+        orderDirty = false;
+    }
+}
+
+bool ofxComponentSpatialIndex::updateEntry(ofxComponentBase* c) {
+    ofRectangle bounds = c->getGlobalBounds();
+
+    auto itr = entries.find(c);
+    if (itr == entries.end()) {
+        Entry e;
+        e.bounds = bounds;
+        insertToNode(c, entries[c] = e);
+        return true;
+    }
+
+    auto& e = itr->second;
+    if (e.bounds == bounds) return false;
+    removeFromNode(e);
+    e.bounds = bounds;
+    insertToNode(c, e);
+    return false;
+}
+
+void ofxComponentSpatialIndex::insertToNode(ofxComponentBase* c, Entry& e) {
+    if (!nodes[0].bounds.inside(e.bounds)) growRoot(e.bounds);
+
+    int n = 0;
+    for (int depth = 0; depth < maxDepth; ++depth) {
+        int q = findQuadrant(nodes[n], e.bounds);
+        if (q < 0) break;
+
+        if (nodes[n].firstChild < 0) {
+            // split
+            ofRectangle b = nodes[n].bounds;
+            float hw = b.width / 2, hh = b.height / 2;
+            int first = nodes.size();
+            nodes.resize(first + 4);
+            nodes[first + 0].bounds = ofRectangle(b.x, b.y, hw, hh);
+            nodes[first + 1].bounds = ofRectangle(b.x + hw, b.y, hw, hh);
+            nodes[first + 2].bounds = ofRectangle(b.x, b.y + hh, hw, hh);
+            nodes[first + 3].bounds = ofRectangle(b.x + hw, b.y + hh, hw, hh);
+            nodes[n].firstChild = first;
+        }
+        n = nodes[n].firstChild + q;
+    }
+
+    e.node = n;
+    e.slot = nodes[n].items.size();
+    nodes[n].items.push_back(c);
+}
+
+void ofxComponentSpatialIndex::removeFromNode(Entry& e) {
+    if (e.node < 0) return;
+    auto& items = nodes[e.node].items;
+
+    // swap with the last item
+    auto last = items.back();
+    items[e.slot] = last;
+    entries[last].slot = e.slot;
+    items.pop_back();
+
+    e.node = -1;
+    e.slot = -1;
+}
+
+void ofxComponentSpatialIndex::growRoot(const ofRectangle& r) {
+    for (int i = 0; i < maxGrowth && !nodes[0].bounds.inside(r); ++i) {
+        ofRectangle b = nodes[0].bounds;
+        if (b.width <= 0 || b.height <= 0) return;
+
+        // grow toward r, the old root ends up on the other side
+        bool left = r.getMinX() < b.getMinX();
+        bool up = r.getMinY() < b.getMinY();
+        ofRectangle grown(left ? b.x - b.width : b.x, up ? b.y - b.height : b.y, b.width * 2, b.height * 2);
+        int q = (left ? 1 : 0) + (up ? 2 : 0);
+
+        int first = nodes.size();
+        nodes.resize(first + 4);
+        float hw = b.width, hh = b.height;
+        for (int k = 0; k < 4; ++k) {
+            nodes[first + k].bounds = ofRectangle(grown.x + (k & 1 ? hw : 0), grown.y + (k & 2 ? hh : 0), hw, hh);
+        }
+        nodes[first + q] = std::move(nodes[0]);
+        for (auto c : nodes[first + q].items) {
+            entries[c].node = first + q;
+        }
+
+        nodes[0] = Node();
+        nodes[0].bounds = grown;
+        nodes[0].firstChild = first;
+    }
+}
+
+int ofxComponentSpatialIndex::findQuadrant(const Node& n, const ofRectangle& r) const {
+    if (!n.bounds.inside(r)) return -1;
+
+    ofVec2f mid = n.bounds.getCenter();
+    int qx, qy;
+    if (r.getMaxX() < mid.x) qx = 0;
+    else if (r.getMinX() >= mid.x) qx = 1;
+    else return -1;
+    if (r.getMaxY() < mid.y) qy = 0;
+    else if (r.getMinY() >= mid.y) qy = 2;
+    else return -1;
+    return qx + qy;
+}
+
+bool ofxComponentSpatialIndex::isUnderRoot(ofxComponentBase* c) const {
+    while (c != nullptr) {
+        if (c == root) return true;
+        c = c->parent.get();
+    }
+    return false;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "ofMain.h"
+
+namespace ofxComponent {
+	class ofxComponentBase;
+
+	// Quadtree over the cached global bounds of components.
+	// ofxComponentManager uses this to find the topmost component under the mouse
+	// without testing every node of the tree.
+	// Components only mark themselves dirty when they move or the tree changes,
+	// bounds and paint order are refreshed lazily on the next query.
+	class ofxComponentSpatialIndex {
+	public:
+		ofxComponentSpatialIndex(ofxComponentBase* root, ofRectangle bounds);
+
+		// c and its whole subtree must be refreshed (moved, reparented)
+		void markDirty(ofxComponentBase* c);
+		// child order changed somewhere, paint order must be renumbered
+		void markOrderDirty();
+		// c and its subtree left the tree
+		void removeSubtree(ofxComponentBase* c);
+		// c is being deleted
+		void remove(ofxComponentBase* c);
+
+		// Components whose global bounds contain p, frontmost first.
+		// This is a broad phase only, the caller must do the exact check.
+		void query(ofVec2f p, vector<ofxComponentBase*>& result);
+
+		size_t size() const { return entries.size(); }
+
+	private:
+		struct Node {
+			ofRectangle bounds;
+			int firstChild = -1; // 4 children from this index, -1 if leaf
+			vector<ofxComponentBase*> items;
+		};
+		struct Entry {
+			ofRectangle bounds;
+			int node = -1;
+			int slot = -1;
+			unsigned int order = 0; // pre-order index = paint order
+		};
+
+		void refresh();
+		void forget(ofxComponentBase* c);
+		// returns true if c was not indexed yet
+		bool updateEntry(ofxComponentBase* c);
+		void insertToNode(ofxComponentBase* c, Entry& e);
+		void removeFromNode(Entry& e);
+		// double the root until it contains r, the old root becomes one of its quadrants
+		void growRoot(const ofRectangle& r);
+		int findQuadrant(const Node& n, const ofRectangle& r) const;
+		bool isUnderRoot(ofxComponentBase* c) const;
+
+		ofxComponentBase* root;
+		vector<Node> nodes;
+		unordered_map<ofxComponentBase*, Entry> entries;
+		unordered_set<ofxComponentBase*> dirty;
+		bool orderDirty = true;
+		vector<ofxComponentBase*> walkStack;
+
+		static const int maxDepth = 8;
+		// far away components stay in the root node instead
+		static const int maxGrowth = 16;
+	};
+}
@@ -0,0 +1,87 @@
+#include "ofxComponentTimerScheduler.h"
+
+using namespace ofxComponent;
+
+ofxComponentTimerScheduler::Timer* ofxComponentTimerScheduler::create(TimerHandle& handle) {
+    if (firstFree < 0) {
+        // add a chunk, slots are linked so that lower indices are used first
+        uint32_t base = chunks.size() * chunkSize;
+        chunks.push_back(unique_ptr<Timer[]>(new Timer[chunkSize]));
+        for (uint32_t i = chunkSize; i > 0; --i) {
+            Timer& t = chunks.back()[i - 1];
+            t.index = base + i - 1;
+            t.generation = 1;
+            t.nextFree = firstFree;
+            firstFree = t.index;
+        }
+    }
+
+    Timer* t = &chunks[firstFree / chunkSize][firstFree % chunkSize];
+    firstFree = t->nextFree;
+    t->nextFree = -1;
+
+    t->execTime = 0.0f;
+    t->done = false;
+    t->running = false;
+    t->paused = false;
+    t->pauseStartTime = 0.0f;
+    t->owner = nullptr;
+    t->id = 0;
+    t->scheduledSeq = 0;
+
+    handle.index = t->index;
+    handle.generation = t->generation;
+    ++numTimers;
+    return t;
+}
+
+ofxComponentTimerScheduler::Timer* ofxComponentTimerScheduler::get(TimerHandle handle) {
+    if (handle.generation == 0 || handle.index >= getPoolCapacity()) return nullptr;
+    Timer* t = &chunks[handle.index / chunkSize][handle.index % chunkSize];
+    if (t->generation != handle.generation) return nullptr;
+    return t;
+}
+
+void ofxComponentTimerScheduler::release(TimerHandle handle) {
+    Timer* t = get(handle);
+    if (t == nullptr) return;
+
+    t->function.reset();
+    t->done = true;
+    t->owner = nullptr;
+
+    // handles to this slot don't resolve anymore
+    if (++t->generation == 0) t->generation = 1;
+
+    t->nextFree = firstFree;
+    firstFree = t->index;
+    --numTimers;
+}
+
+void ofxComponentTimerScheduler::schedule(Timer* timer) {
+    Entry e;
+    e.execTime = timer->execTime;
+    e.seq = ++seqCounter;
+    e.handle.index = timer->index;
+    e.handle.generation = timer->generation;
+    timer->scheduledSeq = e.seq;
+
+    heap.push_back(e);
+    push_heap(heap.begin(), heap.end(), later);
+}
+
+void ofxComponentTimerScheduler::update(float now) {
+    while (!heap.empty() && heap.front().execTime <= now) {
+        pop_heap(heap.begin(), heap.end(), later);
+        Entry e = heap.back();
+        heap.pop_back();
+
+        // stale entry: recycled, canceled, executed, paused (scheduled again on resume) or rescheduled
+        Timer* t = get(e.handle);
+        if (t == nullptr || t->done || t->paused || t->scheduledSeq != e.seq || t->owner == nullptr) continue;
+
+        t->owner->getCold().dueTimers.push_back(e.handle);
+        // reach it even in a sleeping subtree
+        t->owner->requestUpdate();
+    }
+}
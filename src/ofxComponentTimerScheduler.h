@@ -0,0 +1,58 @@
+#pragma once
+#include "ofMain.h"
+#include "ofxComponentBase.h"
+
+namespace ofxComponent {
+	// Pool and min-heap of all component timers.
+	//
+	// Timers are stored in fixed size chunks that never move, and recycled through a free list.
+	// A slot gets a new generation when it is recycled, so old TimerHandles simply stop resolving.
+	//
+	// The heap is keyed by exec time. Each frame only the elapsed timers are touched: they are handed
+	// to their components, which run them at the usual place in their update().
+	// Entries are never removed from the middle of the heap. Canceled, paused or
+	// rescheduled timers leave stale entries that are dropped when they reach the top.
+	class ofxComponentTimerScheduler {
+	public:
+		typedef ofxComponentBase::Timer Timer;
+		typedef ofxComponentBase::TimerHandle TimerHandle;
+
+		// pool
+		Timer* create(TimerHandle& handle);
+		Timer* get(TimerHandle handle);	// nullptr once released
+		void release(TimerHandle handle);
+
+		void schedule(Timer* timer);
+
+		// Deliver all timers elapsed at now, once per frame before the tree update.
+		// Timers that elapse later in the frame (like ones started during the update with no wait)
+		// are delivered in the next frame, and always run inside their owner's update().
+		void update(float now);
+
+		// timers in use
+		size_t getNumTimers() const { return numTimers; }
+		// allocated slots
+		size_t getPoolCapacity() const { return chunks.size() * chunkSize; }
+		// entries in the heap, including stale ones
+		size_t size() const { return heap.size(); }
+
+	private:
+		struct Entry {
+			float execTime;
+			uint64_t seq;
+			TimerHandle handle;
+		};
+		static bool later(const Entry& a, const Entry& b) {
+			if (a.execTime != b.execTime) return a.execTime > b.execTime;
+			return a.seq > b.seq;
+		}
+
+		static const uint32_t chunkSize = 256;
+		vector<unique_ptr<Timer[]> > chunks;
+		int firstFree = -1;
+		size_t numTimers = 0;
+
+		vector<Entry> heap;
+		uint64_t seqCounter = 0;
+	};
+}
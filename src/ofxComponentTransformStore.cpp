@@ -0,0 +1,263 @@
+#include "ofxComponentTransformStore.h"
+#include "ofxComponentBase.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define OFX_COMPONENT_SIMD_WIDTH 8
+typedef __m256 simd_float;
+static inline simd_float simdLoad(const float* p) { return _mm256_loadu_ps(p); }
+static inline void simdStore(float* p, simd_float v) { _mm256_storeu_ps(p, v); }
+static inline simd_float simdMul(simd_float a, simd_float b) { return _mm256_mul_ps(a, b); }
+static inline simd_float simdAdd(simd_float a, simd_float b) { return _mm256_add_ps(a, b); }
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define OFX_COMPONENT_SIMD_WIDTH 4
+typedef __m128 simd_float;
+static inline simd_float simdLoad(const float* p) { return _mm_loadu_ps(p); }
+static inline void simdStore(float* p, simd_float v) { _mm_storeu_ps(p, v); }
+static inline simd_float simdMul(simd_float a, simd_float b) { return _mm_mul_ps(a, b); }
+static inline simd_float simdAdd(simd_float a, simd_float b) { return _mm_add_ps(a, b); }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OFX_COMPONENT_SIMD_WIDTH 4
+typedef float32x4_t simd_float;
+static inline simd_float simdLoad(const float* p) { return vld1q_f32(p); }
+static inline void simdStore(float* p, simd_float v) { vst1q_f32(p, v); }
+static inline simd_float simdMul(simd_float a, simd_float b) { return vmulq_f32(a, b); }
+static inline simd_float simdAdd(simd_float a, simd_float b) { return vaddq_f32(a, b); }
+#endif
+
+using namespace ofxComponent;
+
+ofxComponentTransformStore::ofxComponentTransformStore(ofxComponentBase* _root)
+: root(_root)
+{
+}
+
+ofxComponentTransformStore::~ofxComponentTransformStore() {
+    for (auto n : nodes) {
+        if (n) release(n);
+    }
+}
+
+void ofxComponentTransformStore::update() {
+    if (needRebuild) rebuild();
+    if (!anyDirty) return;
+
+    // parents are always in an earlier range, so one forward pass propagates dirty flags
+    for (size_t i = MAX(firstDirty, (size_t)1); i < nodes.size(); ++i) {
+        dirty[i] |= dirty[parents[i]];
+    }
+
+    for (size_t l = 0; l + 1 < levels.size(); ++l) {
+        if (levels[l + 1] <= firstDirty) continue;
+        updateRange(MAX(levels[l], firstDirty), levels[l + 1]);
+    }
+
+    for (size_t i = firstDirty; i < nodes.size(); ++i) {
+        if (dirty[i]) {
+            versions[i] = ++versionCounter;
+            dirty[i] = 0;
+        }
+    }
+    anyDirty = false;
+    firstDirty = nodes.size();
+}
+
+void ofxComponentTransformStore::setLocal(int index, const ofxComponentAffine2D& m) {
+    la[index] = m.a;
+    lb[index] = m.b;
+    lc[index] = m.c;
+    ld[index] = m.d;
+    ltx[index] = m.tx;
+    lty[index] = m.ty;
+    dirty[index] = 1;
+    if (!anyDirty || (size_t)index < firstDirty) firstDirty = index;
+    anyDirty = true;
+}
+
+ofxComponentAffine2D ofxComponentTransformStore::getGlobal(int index) const {
+    return ofxComponentAffine2D(ga[index], gb[index], gc[index], gd[index], gtx[index], gty[index]);
+}
+
+void ofxComponentTransformStore::remove(int index) {
+    makeHole(index);
+    checkFragmentation();
+}
+
+void ofxComponentTransformStore::attach(ofxComponentBase* c) {
+    if (needRebuild) return;
+    auto p = c->parent.get();
+    if (p == nullptr || p->transformIndex < 0) return;
+    if (c->transformIndex >= 0) detach(c);
+
+    // breadth first after the end, one new range per depth
+    size_t levelBegin = nodes.size();
+    append(c, p->transformIndex);
+    levels.push_back(nodes.size());
+    while (levelBegin < nodes.size()) {
+        size_t levelEnd = nodes.size();
+        for (size_t i = levelBegin; i < levelEnd; ++i) {
+            for (auto cc : nodes[i]->getChildrenView()) {
+                append(cc, i);
+            }
+        }
+        if (nodes.size() > levelEnd) levels.push_back(nodes.size());
+        levelBegin = levelEnd;
+    }
+    checkFragmentation();
+}
+
+void ofxComponentTransformStore::detach(ofxComponentBase* c) {
+    if (needRebuild || c->transformIndex < 0) return;
+
+    vector<ofxComponentBase*> stack(1, c);
+    while (!stack.empty()) {
+        auto n = stack.back();
+        stack.pop_back();
+        if (n->transformIndex < 0) continue;
+        makeHole(n->transformIndex);
+        release(n);
+        for (auto cc : n->getChildrenView()) {
+            stack.push_back(cc);
+        }
+    }
+    checkFragmentation();
+}
+
+void ofxComponentTransformStore::append(ofxComponentBase* c, int parent) {
+    int index = nodes.size();
+    nodes.push_back(c);
+    parents.push_back(parent);
+    for (auto v : { &la, &lb, &lc, &ld, &ltx, &lty, &ga, &gb, &gc, &gd, &gtx, &gty }) {
+        v->push_back(0);
+    }
+    dirty.push_back(1);
+    versions.push_back(0);
+    c->transformIndex = index;
+    setLocal(index, c->localMatrix);
+    // versions of a component never repeat, whether they come from here or not
+    versionCounter = MAX(versionCounter, c->globalVersion);
+}
+
+void ofxComponentTransformStore::makeHole(int index) {
+    if (nodes[index] == nullptr) return;
+    nodes[index] = nullptr;
+    // computed like any other node, nobody reads it
+    parents[index] = index;
+    dirty[index] = 0;
+    ++holes;
+}
+
+void ofxComponentTransformStore::release(ofxComponentBase* c) {
+    c->transformIndex = -1;
+    // recomputed recursively on next read
+    ++c->localVersion;
+}
+
+void ofxComponentTransformStore::checkFragmentation() {
+    // too many holes, or too many small ranges for SIMD
+    if (holes * 2 > nodes.size() || levels.size() > builtLevels * 2 + 64) needRebuild = true;
+}
+
+void ofxComponentTransformStore::rebuild() {
+    for (auto n : nodes) {
+        if (n) release(n);
+    }
+    nodes.clear();
+    parents.clear();
+    levels.clear();
+    holes = 0;
+
+    // breadth first
+    nodes.push_back(root);
+    parents.push_back(-1);
+    size_t levelBegin = 0;
+    while (levelBegin < nodes.size()) {
+        levels.push_back(levelBegin);
+        size_t levelEnd = nodes.size();
+        for (size_t i = levelBegin; i < levelEnd; ++i) {
+            for (auto c : nodes[i]->getChildrenView()) {
+                nodes.push_back(c);
+                parents.push_back(i);
+            }
+        }
+        levelBegin = levelEnd;
+    }
+    levels.push_back(nodes.size());
+    builtLevels = levels.size();
+
+    size_t n = nodes.size();
+    for (auto v : { &la, &lb, &lc, &ld, &ltx, &lty, &ga, &gb, &gc, &gd, &gtx, &gty }) {
+        v->resize(n);
+    }
+    dirty.assign(n, 1);
+    versions.assign(n, 0);
+    anyDirty = true;
+    firstDirty = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        nodes[i]->transformIndex = i;
+        setLocal(i, nodes[i]->localMatrix);
+        versionCounter = MAX(versionCounter, nodes[i]->globalVersion);
+    }
+
+    needRebuild = false;
+}
+
+void ofxComponentTransformStore::updateRange(size_t begin, size_t end) {
+    size_t i = begin;
+
+    // global = local * parent global
+#ifdef OFX_COMPONENT_SIMD_WIDTH
+    const size_t w = OFX_COMPONENT_SIMD_WIDTH;
+    float pa[w], pb[w], pc[w], pd[w], ptx[w], pty[w];
+    for (; i + w <= end; i += w) {
+        bool need = false;
+        for (size_t k = 0; k < w; ++k) need |= dirty[i + k] != 0;
+        if (!need) continue;
+
+        // gather parents
+        for (size_t k = 0; k < w; ++k) {
+            int p = parents[i + k];
+            pa[k] = ga[p];
+            pb[k] = gb[p];
+            pc[k] = gc[p];
+            pd[k] = gd[p];
+            ptx[k] = gtx[p];
+            pty[k] = gty[p];
+        }
+        simd_float vpa = simdLoad(pa), vpb = simdLoad(pb), vpc = simdLoad(pc), vpd = simdLoad(pd);
+        simd_float va = simdLoad(&la[i]), vb = simdLoad(&lb[i]), vc = simdLoad(&lc[i]), vd = simdLoad(&ld[i]);
+        simd_float vtx = simdLoad(&ltx[i]), vty = simdLoad(&lty[i]);
+
+        simdStore(&ga[i], simdAdd(simdMul(va, vpa), simdMul(vb, vpc)));
+        simdStore(&gb[i], simdAdd(simdMul(va, vpb), simdMul(vb, vpd)));
+        simdStore(&gc[i], simdAdd(simdMul(vc, vpa), simdMul(vd, vpc)));
+        simdStore(&gd[i], simdAdd(simdMul(vc, vpb), simdMul(vd, vpd)));
+        simdStore(&gtx[i], simdAdd(simdAdd(simdMul(vtx, vpa), simdMul(vty, vpc)), simdLoad(ptx)));
+        simdStore(&gty[i], simdAdd(simdAdd(simdMul(vtx, vpb), simdMul(vty, vpd)), simdLoad(pty)));
+    }
+#endif
+
+    // rest, and the root
+    for (; i < end; ++i) {
+        if (!dirty[i]) continue;
+        int p = parents[i];
+        if (p < 0) {
+            ga[i] = la[i];
+            gb[i] = lb[i];
+            gc[i] = lc[i];
+            gd[i] = ld[i];
+            gtx[i] = ltx[i];
+            gty[i] = lty[i];
+            continue;
+        }
+        ga[i] = la[i] * ga[p] + lb[i] * gc[p];
+        gb[i] = la[i] * gb[p] + lb[i] * gd[p];
+        gc[i] = lc[i] * ga[p] + ld[i] * gc[p];
+        gd[i] = lc[i] * gb[p] + ld[i] * gd[p];
+        gtx[i] = ltx[i] * ga[p] + lty[i] * gc[p] + gtx[p];
+        gty[i] = ltx[i] * gb[p] + lty[i] * gd[p] + gty[p];
+    }
+}
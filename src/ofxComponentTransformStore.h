@@ -0,0 +1,65 @@
+#pragma once
+#include "ofMain.h"
+#include "ofxComponentAffine2D.h"
+
+namespace ofxComponent {
+	class ofxComponentBase;
+
+	// Flat mirror of all transforms under the root component.
+	// Local and global transforms are kept as separate float arrays (structure of arrays)
+	// in ranges of one depth, every parent before its children,
+	// so all nodes of a range can be computed together with SIMD.
+	// Components still own their matrices for the getters: setLocal() copies the local one in,
+	// and a component copies its global one back when it reads it and it has changed.
+	// Added subtrees are appended as new ranges and removed ones leave holes,
+	// the whole order is rebuilt only when that has fragmented it.
+	class ofxComponentTransformStore {
+	public:
+		ofxComponentTransformStore(ofxComponentBase* root);
+		~ofxComponentTransformStore();
+
+		// Recompute all dirty global transforms in one pass.
+		// The order is rebuilt first if it is too fragmented.
+		void update();
+
+		// c was added under a parent in the store, append its subtree
+		void attach(ofxComponentBase* c);
+		// c and its subtree left the tree
+		void detach(ofxComponentBase* c);
+
+		void setLocal(int index, const ofxComponentAffine2D& m);
+		ofxComponentAffine2D getGlobal(int index) const;
+		// changes every time the global transform of index is recomputed, never repeats
+		unsigned int getGlobalVersion(int index) const { return versions[index]; }
+
+		// the component at index is being deleted
+		void remove(int index);
+
+		size_t size() const { return nodes.size(); }
+
+	private:
+		void rebuild();
+		void updateRange(size_t begin, size_t end);
+		void append(ofxComponentBase* c, int parent);
+		void makeHole(int index);
+		// hand the transform back to the component
+		void release(ofxComponentBase* c);
+		void checkFragmentation();
+
+		ofxComponentBase* root;
+		bool needRebuild = true;
+		size_t holes = 0;
+		size_t builtLevels = 0;
+		bool anyDirty = false;
+		size_t firstDirty = 0; // nothing before it is dirty
+		unsigned int versionCounter = 0;
+
+		vector<ofxComponentBase*> nodes;
+		vector<int> parents;         // -1 for root
+		vector<size_t> levels;       // first index of each range, and size() at the end
+		vector<float> la, lb, lc, ld, ltx, lty; // local
+		vector<float> ga, gb, gc, gd, gtx, gty; // global
+		vector<unsigned char> dirty;
+		vector<unsigned int> versions;
+	};
+}
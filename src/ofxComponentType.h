@@ -0,0 +1,60 @@
+#pragma once
+#include "ofMain.h"
+
+#if defined(__GXX_RTTI) || defined(_CPPRTTI) || defined(__cpp_rtti)
+#define OFX_COMPONENT_RTTI
+#endif
+
+// Gives a component class its own ofxComponentTypeInfo, for is<T>(), as<T>() and findAll<T>().
+// Put it first in the class body, it leaves the access at private:
+//
+// class Button : public ofxComponentBase {
+//     OFX_COMPONENT_TYPE(Button, ofxComponentBase)
+// public:
+//     ...
+//
+// Base is the registered component class Class derives from.
+// Classes without it are treated as their closest registered base.
+#define OFX_COMPONENT_TYPE(Class, Base) \
+public: \
+	typedef Class ofxComponentSelfType; \
+	static const ofxComponent::ofxComponentTypeInfo& staticType() { \
+		static const ofxComponent::ofxComponentTypeInfo info(#Class, &Base::staticType()); \
+		return info; \
+	} \
+	const ofxComponent::ofxComponentTypeInfo& getType() const override { return staticType(); } \
+private:
+
+namespace ofxComponent {
+	// Identity of a registered component class, without RTTI.
+	// Each one keeps the chain of its bases indexed by depth,
+	// so isA() is one comparison however deep the hierarchy is.
+	class ofxComponentTypeInfo {
+	public:
+		ofxComponentTypeInfo(const char* _name, const ofxComponentTypeInfo* _base)
+			: name(_name), base(_base) {
+			if (base) ancestors = base->ancestors;
+			depth = ancestors.size();
+			ancestors.push_back(this);
+		}
+
+		ofxComponentTypeInfo(const ofxComponentTypeInfo&) = delete;
+		ofxComponentTypeInfo& operator=(const ofxComponentTypeInfo&) = delete;
+
+		// true for the same class or a class derived from other
+		bool isA(const ofxComponentTypeInfo& other) const {
+			return other.depth <= depth && ancestors[other.depth] == &other;
+		}
+
+		const char* getName() const { return name; }
+		// nullptr for ofxComponentBase
+		const ofxComponentTypeInfo* getBase() const { return base; }
+
+	private:
+		const char* name;
+		const ofxComponentTypeInfo* base;
+		size_t depth;
+		// root first, this last
+		vector<const ofxComponentTypeInfo*> ancestors;
+	};
+}
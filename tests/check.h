@@ -0,0 +1,7 @@
+#pragma once
+#include "ofMain.h"
+
+// CHECK() prints the failed condition and keeps going, main() returns checkResult().
+inline int& checkFailures() { static int n = 0; return n; }
+#define CHECK(cond) do { if (!(cond)) { ++checkFailures(); printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } } while (0)
+inline int checkResult() { return checkFailures() == 0 ? 0 : 1; }
@@ -0,0 +1,63 @@
+// Render targets of constrained components shared from the pool.
+#include "check.h"
+#include "ofxComponent.h"
+using namespace ofxComponent;
+
+int main() {
+	auto m = make_shared<ofxComponentManager>();
+	m->setup();
+	m->setFboPoolEnabled(true);
+	vector<shared_ptr<ofxComponentBase> > windows;
+	for (int i = 0; i < 10; ++i) {
+		auto w = make_shared<ofxComponentBase>();
+		w->setRect(i * 10, 0, 200, 150);
+		w->setConstrain(true);
+		m->addChild(w);
+		windows.push_back(w);
+		// nested: needs a second target while the window's is bound
+		auto inner = make_shared<ofxComponentBase>();
+		inner->setRect(10, 10, 50, 50);
+		inner->setConstrain(true);
+		w->addChild(inner);
+	}
+	ofEventArgs e;
+	m->update(e);
+	m->draw(e);
+
+	// one per nesting level, shared by the siblings
+	auto s = m->getFboPoolStats();
+	CHECK(s.allocations == 2);
+	CHECK(s.inUse == 0);
+	CHECK(s.pooled == 2);
+
+	// resizing inside the size class reuses the same targets
+	for (int f = 0; f < 40; ++f) {
+		for (auto& w : windows) { w->setWidth(200 + f); w->setHeight(150 + f / 2); }
+		m->update(e);
+		m->draw(e);
+	}
+	s = m->getFboPoolStats();
+	CHECK(s.allocations == 2);
+	CHECK(s.reuses == 41 * 20 - 2);
+
+	// growing past it allocates once for the new class
+	for (auto& w : windows) w->setWidth(300);
+	m->update(e);
+	m->draw(e);
+	s = m->getFboPoolStats();
+	CHECK(s.allocations == 3);
+	CHECK(s.inUse == 0);
+	for (auto& w : windows) { w->setWidth(310); w->setHeight(160); }
+	m->update(e);
+	m->draw(e);
+	CHECK(m->getFboPoolStats().allocations == 3);
+
+	// disabling frees everything
+	m->setFboPoolEnabled(false);
+	s = m->getFboPoolStats();
+	CHECK(s.pooled == 0);
+	CHECK(s.bytes == 0);
+	m->draw(e);
+
+	return checkResult();
+}
@@ -0,0 +1,125 @@
+// Topmost component under the mouse, by the tree walk and by the quadtree.
+#include "check.h"
+#include "ofxComponent.h"
+using namespace ofxComponent;
+
+vector<shared_ptr<ofxComponentBase> > all;
+
+ofxComponentBase* topAt(shared_ptr<ofxComponentManager> m, float x, float y) {
+	ofstub::mx() = x; ofstub::my() = y;
+	ofMouseEventArgs args;
+	m->mouseMoved(args);
+	ofxComponentBase* top = nullptr;
+	for (auto& c : all) {
+		if (c->isMouseOver()) {
+			CHECK(top == nullptr); // only one
+			top = c.get();
+		}
+	}
+	return top;
+}
+
+shared_ptr<ofxComponentBase> add(shared_ptr<ofxComponentBase> parent, float x, float y, float w, float h) {
+	auto c = make_shared<ofxComponentBase>();
+	c->setRect(x, y, w, h);
+	parent->addChild(c);
+	all.push_back(c);
+	return c;
+}
+
+// later siblings are above earlier ones, children above their parent,
+// constrained parents clip their children and inactive ones are skipped
+void testOrder(bool spatialIndex) {
+	all.clear();
+	auto m = make_shared<ofxComponentManager>();
+	m->setup();
+	m->setSpatialIndexEnabled(spatialIndex);
+
+	auto a = add(m, 0, 0, 100, 100);
+	auto b = add(m, 50, 50, 100, 100);
+	auto child = add(a, 10, 10, 20, 20);
+	auto clip = add(m, 300, 0, 100, 100);
+	clip->setConstrain(true);
+	auto outside = add(clip, 80, 0, 100, 100);
+	auto hidden = add(m, 500, 0, 100, 100);
+	hidden->setActive(false);
+	ofEventArgs e; m->update(e);
+
+	CHECK(topAt(m, 75, 75) == b.get());
+	CHECK(topAt(m, 20, 20) == child.get());
+	CHECK(topAt(m, 40, 40) == a.get());
+	CHECK(topAt(m, 390, 50) == outside.get());
+	CHECK(topAt(m, 420, 50) == nullptr);
+	CHECK(topAt(m, 550, 50) == nullptr);
+
+	// later in the children is above
+	m->swapChild(0, 1);
+	CHECK(topAt(m, 75, 75) == a.get());
+	b->setPos(60, 60);
+	a->setPos(200, 200);
+	CHECK(topAt(m, 75, 75) == b.get());
+}
+
+// the quadtree finds the same components as the tree walk, also after edits
+void testQuadtree() {
+	all.clear();
+	ofSeedRandom(1);
+	auto m = make_shared<ofxComponentManager>();
+	m->setup();
+	function<void(shared_ptr<ofxComponentBase>, int)> build = [&](shared_ptr<ofxComponentBase> p, int depth) {
+		for (int i = 0; i < (depth == 0 ? 20 : 4); ++i) {
+			auto c = add(p, ofRandom(0, 800), ofRandom(0, 600), ofRandom(10, 200), ofRandom(10, 200));
+			if (rand() % 3 == 0) c->setRotation(ofRandom(0, 90));
+			if (rand() % 3 == 0) c->setScale(ofRandom(0.5, 1.5));
+			if (rand() % 5 == 0) c->setConstrain(true);
+			if (rand() % 10 == 0) c->setActive(false);
+			if (depth < 2) build(c, depth + 1);
+		}
+	};
+	build(m, 0);
+	ofEventArgs e; m->update(e);
+
+	auto compare = [&]() {
+		int mismatches = 0;
+		for (int k = 0; k < 500; ++k) {
+			float x = ofRandom(-100, 1100), y = ofRandom(-100, 900);
+			m->setSpatialIndexEnabled(false);
+			auto walked = topAt(m, x, y);
+			m->setSpatialIndexEnabled(true);
+			if (topAt(m, x, y) != walked) ++mismatches;
+		}
+		return mismatches;
+	};
+	CHECK(compare() == 0);
+
+	// move, rotate, reparent and reorder with the index enabled
+	m->setSpatialIndexEnabled(true);
+	for (int k = 0; k < 300; ++k) {
+		auto& c = all[rand() % all.size()];
+		int op = rand() % 4;
+		if (op == 0) c->setPos(ofRandom(0, 800), ofRandom(0, 600));
+		if (op == 1) c->setRotation(ofRandom(0, 90));
+		if (op == 2) {
+			auto& p = all[rand() % all.size()];
+			bool cycle = false;
+			for (ofxComponentBase* q = p.get(); q; q = q->getParent().get()) if (q == c.get()) cycle = true;
+			if (!cycle) c->setParent(p);
+		}
+		if (op == 3 && c->getParent()) c->getParent()->swapChild(0, c->getParent()->getChildren().size() - 1);
+		topAt(m, ofRandom(0, 1024), ofRandom(0, 768));
+	}
+	CHECK(compare() == 0);
+
+	// far outside of the initial bounds
+	add(m, 5000, -3000, 50, 50);
+	CHECK(compare() == 0);
+	m->setSpatialIndexEnabled(true);
+	CHECK(topAt(m, 5025, -2975) == all.back().get());
+}
+
+int main() {
+	testOrder(false);
+	testOrder(true);
+	testQuadtree();
+	return checkResult();
+}
@@ -0,0 +1,322 @@
+// Minimal stand-in for the parts of openFrameworks the addon uses, to build and run the tests without a GL context.
+// Drawing only counts calls, time and mouse position are set by the tests through ofstub::.
+#pragma once
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <cstring>
+#include <cstdint>
+#include <typeinfo>
+#include <typeindex>
+#include <fstream>
+using namespace std;
+
+#define DEG_TO_RAD (3.14159265358979323846/180.0)
+#define RAD_TO_DEG (180.0/3.14159265358979323846)
+#ifndef MAX
+#define MAX(x,y) (((x) > (y)) ? (x) : (y))
+#define MIN(x,y) (((x) < (y)) ? (x) : (y))
+#endif
+
+struct ofVec3f;
+struct ofVec2f {
+	float x = 0, y = 0;
+	ofVec2f() {}
+	ofVec2f(float x, float y) : x(x), y(y) {}
+	void set(float _x, float _y) { x = _x; y = _y; }
+	ofVec2f(const ofVec3f& v);
+	ofVec2f operator+(const ofVec2f& o) const { return ofVec2f(x + o.x, y + o.y); }
+	ofVec2f operator-(const ofVec2f& o) const { return ofVec2f(x - o.x, y - o.y); }
+	ofVec2f operator*(float s) const { return ofVec2f(x * s, y * s); }
+	bool operator==(const ofVec2f& o) const { return x == o.x && y == o.y; }
+	float length() const { return sqrtf(x * x + y * y); }
+};
+struct ofVec3f {
+	float x = 0, y = 0, z = 0;
+	ofVec3f() {}
+	ofVec3f(float x, float y, float z = 0) : x(x), y(y), z(z) {}
+	ofVec3f(const ofVec2f& v) : x(v.x), y(v.y), z(0) {}
+};
+inline ofVec2f::ofVec2f(const ofVec3f& v) : x(v.x), y(v.y) {}
+typedef ofVec3f glm_vec3;
+
+struct ofRectangle {
+	float x = 0, y = 0, width = 0, height = 0;
+	ofRectangle() {}
+	ofRectangle(float x, float y, float w, float h) : x(x), y(y), width(w), height(h) {}
+	bool operator==(const ofRectangle& o) const { return x == o.x && y == o.y && width == o.width && height == o.height; }
+	bool operator!=(const ofRectangle& o) const { return !(*this == o); }
+	ofVec2f getCenter() const { return ofVec2f(x + width / 2, y + height / 2); }
+	void standardize() { if (width < 0) { x += width; width = -width; } if (height < 0) { y += height; height = -height; } }
+	float getMinX() const { return std::min(x, x + width); }
+	float getMaxX() const { return std::max(x, x + width); }
+	float getMinY() const { return std::min(y, y + height); }
+	float getMaxY() const { return std::max(y, y + height); }
+	float getLeft() const { return getMinX(); }
+	float getRight() const { return getMaxX(); }
+	float getTop() const { return getMinY(); }
+	float getBottom() const { return getMaxY(); }
+	float getArea() const { return fabsf(width) * fabsf(height); }
+	bool inside(float px, float py) const { return px >= getMinX() && py >= getMinY() && px <= getMaxX() && py <= getMaxY(); }
+	bool inside(const ofVec2f& p) const { return inside(p.x, p.y); }
+	bool inside(const ofRectangle& r) const { return inside(r.getMinX(), r.getMinY()) && inside(r.getMaxX(), r.getMaxY()); }
+	bool intersects(const ofRectangle& r) const { return getMinX() < r.getMaxX() && getMaxX() > r.getMinX() && getMinY() < r.getMaxY() && getMaxY() > r.getMinY(); }
+	ofRectangle getIntersection(const ofRectangle& r) const {
+		float x0 = std::max(getMinX(), r.getMinX()), x1 = std::min(getMaxX(), r.getMaxX());
+		float y0 = std::max(getMinY(), r.getMinY()), y1 = std::min(getMaxY(), r.getMaxY());
+		if (x1 < x0 || y1 < y0) return ofRectangle();
+		return ofRectangle(x0, y0, x1 - x0, y1 - y0);
+	}
+	void growToInclude(float px, float py) {
+		float x0 = std::min(getMinX(), px), x1 = std::max(getMaxX(), px);
+		float y0 = std::min(getMinY(), py), y1 = std::max(getMaxY(), py);
+		x = x0; y = y0; width = x1 - x0; height = y1 - y0;
+	}
+	void growToInclude(const ofVec2f& p) { growToInclude(p.x, p.y); }
+	void growToInclude(const ofRectangle& r) { growToInclude(r.getMinX(), r.getMinY()); growToInclude(r.getMaxX(), r.getMaxY()); }
+	bool isEmpty() const { return width == 0 && height == 0; }
+	void set(float px, float py, float w, float h) { x = px; y = py; width = w; height = h; }
+};
+
+struct ofQuaternion {
+	float z = 0;
+	ofVec3f getEuler() const { return ofVec3f(0, 0, z); }
+};
+
+// row-vector convention, like oF (OSG)
+struct ofMatrix4x4 {
+	float _mat[4][4];
+	ofMatrix4x4() { makeIdentityMatrix(); }
+	ofMatrix4x4(float a00, float a01, float a02, float a03,
+		float a10, float a11, float a12, float a13,
+		float a20, float a21, float a22, float a23,
+		float a30, float a31, float a32, float a33) {
+		float v[16] = { a00,a01,a02,a03,a10,a11,a12,a13,a20,a21,a22,a23,a30,a31,a32,a33 };
+		for (int i = 0; i < 16; ++i) _mat[i / 4][i % 4] = v[i];
+	}
+	void makeIdentityMatrix() { for (int r = 0; r < 4; ++r) for (int c = 0; c < 4; ++c) _mat[r][c] = r == c ? 1 : 0; }
+	float& operator()(int r, int c) { return _mat[r][c]; }
+	float operator()(int r, int c) const { return _mat[r][c]; }
+	const float* getPtr() const { return &_mat[0][0]; }
+	ofMatrix4x4 operator*(const ofMatrix4x4& o) const {
+		ofMatrix4x4 m;
+		for (int r = 0; r < 4; ++r) for (int c = 0; c < 4; ++c) {
+			float s = 0; for (int k = 0; k < 4; ++k) s += _mat[r][k] * o._mat[k][c]; m._mat[r][c] = s;
+		}
+		return m;
+	}
+	static ofMatrix4x4 newTranslationMatrix(float x, float y, float z) { ofMatrix4x4 m; m._mat[3][0] = x; m._mat[3][1] = y; m._mat[3][2] = z; return m; }
+	void translate(const ofVec3f& v) { *this = *this * newTranslationMatrix(v.x, v.y, v.z); }
+	void translate(float x, float y, float z) { translate(ofVec3f(x, y, z)); }
+	void scale(const ofVec3f& v) { ofMatrix4x4 m; m._mat[0][0] = v.x; m._mat[1][1] = v.y; m._mat[2][2] = v.z; *this = *this * m; }
+	void scale(float x, float y, float z) { scale(ofVec3f(x, y, z)); }
+	void rotateRad(float a, float, float, float) { ofMatrix4x4 m; m._mat[0][0] = cosf(a); m._mat[0][1] = sinf(a); m._mat[1][0] = -sinf(a); m._mat[1][1] = cosf(a); *this = *this * m; }
+	void rotate(float deg, float x, float y, float z) { rotateRad(deg * DEG_TO_RAD, x, y, z); }
+	ofVec3f preMult(const ofVec3f& v) const {
+		float d = 1.0f / (_mat[0][3] * v.x + _mat[1][3] * v.y + _mat[2][3] * v.z + _mat[3][3]);
+		return ofVec3f((_mat[0][0] * v.x + _mat[1][0] * v.y + _mat[2][0] * v.z + _mat[3][0]) * d,
+			(_mat[0][1] * v.x + _mat[1][1] * v.y + _mat[2][1] * v.z + _mat[3][1]) * d,
+			(_mat[0][2] * v.x + _mat[1][2] * v.y + _mat[2][2] * v.z + _mat[3][2]) * d);
+	}
+	ofMatrix4x4 getInverse() const {
+		// 2D affine inverse is enough for the stub
+		float a = _mat[0][0], b = _mat[0][1], c = _mat[1][0], d = _mat[1][1], tx = _mat[3][0], ty = _mat[3][1];
+		float det = a * d - b * c; ofMatrix4x4 m;
+		m._mat[0][0] = d / det; m._mat[0][1] = -b / det; m._mat[1][0] = -c / det; m._mat[1][1] = a / det;
+		m._mat[3][0] = -(tx * m._mat[0][0] + ty * m._mat[1][0]); m._mat[3][1] = -(tx * m._mat[0][1] + ty * m._mat[1][1]);
+		m._mat[2][2] = _mat[2][2] != 0 ? 1 / _mat[2][2] : 1;
+		return m;
+	}
+	ofVec3f getScale() const { return ofVec3f(sqrtf(_mat[0][0] * _mat[0][0] + _mat[0][1] * _mat[0][1]), sqrtf(_mat[1][0] * _mat[1][0] + _mat[1][1] * _mat[1][1]), 1); }
+	ofQuaternion getRotate() const { ofQuaternion q; q.z = atan2f(_mat[0][1], _mat[0][0]) * RAD_TO_DEG; return q; }
+	ofVec3f getTranslation() const { return ofVec3f(_mat[3][0], _mat[3][1], _mat[3][2]); }
+};
+
+// ---- events
+class ofEventArgs {};
+class ofKeyEventArgs : public ofEventArgs { public: int key = 0; };
+class ofMouseEventArgs : public ofEventArgs { public: float x = 0, y = 0; int button = 0; float scrollX = 0, scrollY = 0; };
+class ofDragInfo { public: vector<string> files; ofVec2f position; };
+enum ofEventOrder { OF_EVENT_ORDER_BEFORE_APP = 0, OF_EVENT_ORDER_APP = 100, OF_EVENT_ORDER_AFTER_APP = 200 };
+
+template<typename T> class ofEvent {
+public:
+	vector<pair<const void*, function<void(T&)>>> fns;
+	template<class O> void add(O* o, void (O::*m)(T&)) { fns.push_back(make_pair((const void*)o, [o, m](T& a) { (o->*m)(a); })); }
+	void remove(const void* o) { fns.erase(remove_if(fns.begin(), fns.end(), [o](const pair<const void*, function<void(T&)>>& f) { return f.first == o; }), fns.end()); }
+	void notify(T& a) { auto copy = fns; for (auto& f : copy) f.second(a); }
+};
+template<> class ofEvent<void> {
+public:
+	vector<pair<const void*, function<void()>>> fns;
+	template<class O> void add(O* o, void (O::*m)()) { fns.push_back(make_pair((const void*)o, [o, m]() { (o->*m)(); })); }
+	void remove(const void* o) { fns.erase(remove_if(fns.begin(), fns.end(), [o](const pair<const void*, function<void()>>& f) { return f.first == o; }), fns.end()); }
+	void notify() { auto copy = fns; for (auto& f : copy) f.second(); }
+	template<class F> unique_ptr<int> newListener(F f, int = 0) { fns.push_back(make_pair((const void*)nullptr, function<void()>(f))); return make_unique<int>(0); }
+};
+template<class T, class O> void ofAddListener(ofEvent<T>& e, O* o, void (O::*m)(T&), int = 0) { e.add(o, m); }
+template<class O> void ofAddListener(ofEvent<void>& e, O* o, void (O::*m)(), int = 0) { e.add(o, m); }
+// removes all listeners of the object, enough for the addon
+template<class T, class O> void ofRemoveListener(ofEvent<T>& e, O* o, void (O::*)(T&), int = 0) { e.remove(o); }
+template<class O> void ofRemoveListener(ofEvent<void>& e, O* o, void (O::*)(), int = 0) { e.remove(o); }
+template<class T> void ofNotifyEvent(ofEvent<T>& e, T& a) { e.notify(a); }
+inline void ofNotifyEvent(ofEvent<void>& e) { e.notify(); }
+
+namespace ofstub { float& mx(); float& my(); float& pmx(); float& pmy(); }
+struct ofCoreEvents {
+	ofEvent<ofEventArgs> update, draw, exit;
+	ofEvent<ofKeyEventArgs> keyPressed, keyReleased;
+	ofEvent<ofMouseEventArgs> mouseMoved, mousePressed, mouseDragged, mouseReleased, mouseScrolled;
+	ofEvent<ofDragInfo> fileDragEvent;
+	bool notifyMouseMoved(float x, float y) { ofstub::pmx() = ofstub::mx(); ofstub::pmy() = ofstub::my(); ofstub::mx() = x; ofstub::my() = y; ofMouseEventArgs a; a.x = x; a.y = y; mouseMoved.notify(a); return false; }
+};
+// never destroyed, components still registered at exit remove their listeners after statics are gone
+inline ofCoreEvents& ofEvents() { static ofCoreEvents* e = new ofCoreEvents(); return *e; }
+
+// ---- time / window / mouse
+namespace ofstub {
+	inline float& now() { static float t = 0; return t; }
+	inline float& mx() { static float v = 0; return v; }
+	inline float& my() { static float v = 0; return v; }
+	inline float& pmx() { static float v = 0; return v; }
+	inline float& pmy() { static float v = 0; return v; }
+	inline uint64_t& frame() { static uint64_t f = 0; return f; }
+	inline int& drawCalls() { static int v = 0; return v; }
+	inline int& fboBegins() { static int v = 0; return v; }
+}
+inline float ofGetElapsedTimef() { return ofstub::now(); }
+inline uint64_t ofGetElapsedTimeMillis() { return (uint64_t)(ofstub::now() * 1000); }
+inline uint64_t ofGetElapsedTimeMicros() { return (uint64_t)(ofstub::now() * 1000000); }
+inline uint64_t ofGetFrameNum() { return ofstub::frame(); }
+inline float ofGetFrameRate() { return 60; }
+inline int ofGetMouseX() { return (int)ofstub::mx(); }
+inline int ofGetMouseY() { return (int)ofstub::my(); }
+inline int ofGetPreviousMouseX() { return (int)ofstub::pmx(); }
+inline int ofGetPreviousMouseY() { return (int)ofstub::pmy(); }
+inline int ofGetWidth() { return 1024; }
+inline int ofGetHeight() { return 768; }
+inline int ofGetViewportWidth() { return 1024; }
+inline int ofGetViewportHeight() { return 768; }
+inline ofRectangle ofGetCurrentViewport() { return ofRectangle(0, 0, 1024, 768); }
+inline ofRectangle ofGetNativeViewport() { return ofRectangle(0, 0, 1024, 768); }
+inline bool ofIsVFlipped() { return true; }
+
+// ---- graphics
+enum ofMatrixMode { OF_MATRIX_MODELVIEW, OF_MATRIX_PROJECTION, OF_MATRIX_TEXTURE };
+inline ofMatrix4x4& ofstubCurrentMatrix() { static ofMatrix4x4 m; return m; }
+inline vector<ofMatrix4x4>& ofstubMatrixStack() { static vector<ofMatrix4x4> s; return s; }
+inline void ofPushMatrix() { ofstubMatrixStack().push_back(ofstubCurrentMatrix()); }
+inline void ofPopMatrix() { ofstubCurrentMatrix() = ofstubMatrixStack().back(); ofstubMatrixStack().pop_back(); }
+inline void ofMultMatrix(const ofMatrix4x4& m) { ofstubCurrentMatrix() = m * ofstubCurrentMatrix(); }
+inline void ofLoadMatrix(const ofMatrix4x4& m) { ofstubCurrentMatrix() = m; }
+inline void ofTranslate(float x, float y, float z = 0) { ofMultMatrix(ofMatrix4x4::newTranslationMatrix(x, y, z)); }
+inline int* ofstubViewport() { static int v[4] = { 0, 0, 1024, 768 }; return v; }
+// screen pixels, y down, to NDC like oF's flipped ortho setup
+inline ofMatrix4x4 ofstubProjection() { int* v = ofstubViewport(); return ofMatrix4x4(2.0f / v[2], 0, 0, 0, 0, -2.0f / v[3], 0, 0, 0, 0, 1, 0, -1, 1, 0, 1); }
+inline ofMatrix4x4 ofGetCurrentMatrix(ofMatrixMode mode) { return mode == OF_MATRIX_PROJECTION ? ofstubProjection() : ofstubCurrentMatrix(); }
+inline ofMatrix4x4 ofGetCurrentViewMatrix() { return ofMatrix4x4(); }
+inline void ofPushStyle() {}
+inline void ofPopStyle() {}
+inline void ofClear(float, float, float, float) {}
+inline void ofSetColor(float, float, float, float = 255) {}
+inline void ofDrawRectangle(float, float, float, float) { ofstub::drawCalls()++; }
+inline void ofPushView() {}
+inline void ofPopView() {}
+inline void ofViewport(float, float, float, float, bool = true) {}
+inline void ofSetupScreen() {}
+
+typedef unsigned int GLuint;
+typedef int GLint;
+typedef int GLsizei;
+typedef unsigned int GLenum;
+typedef unsigned char GLboolean;
+#define GL_SCISSOR_TEST 0x0C11
+#define GL_SCISSOR_BOX 0x0C10
+#define GL_VIEWPORT 0x0BA2
+#define GL_RGBA 0x1908
+#define GL_RGBA8 0x8058
+inline bool& ofstubScissorEnabled() { static bool v = false; return v; }
+inline GLint* ofstubScissorBox() { static GLint b[4] = { 0,0,0,0 }; return b; }
+inline void glEnable(GLenum e) { if (e == GL_SCISSOR_TEST) ofstubScissorEnabled() = true; }
+inline void glDisable(GLenum e) { if (e == GL_SCISSOR_TEST) ofstubScissorEnabled() = false; }
+inline GLboolean glIsEnabled(GLenum e) { return e == GL_SCISSOR_TEST ? ofstubScissorEnabled() : 0; }
+inline void glScissor(GLint x, GLint y, GLsizei w, GLsizei h) { GLint* b = ofstubScissorBox(); b[0] = x; b[1] = y; b[2] = w; b[3] = h; }
+inline void glGetIntegerv(GLenum e, GLint* v) { GLint* b = e == GL_VIEWPORT ? ofstubViewport() : ofstubScissorBox(); for (int i = 0; i < 4; ++i) v[i] = b[i]; }
+
+class ofTexture {
+public:
+	float w = 0, h = 0;
+	bool isAllocated() const { return w > 0; }
+	float getWidth() const { return w; }
+	float getHeight() const { return h; }
+	void draw(float, float) const { ofstub::drawCalls()++; }
+	void draw(float, float, float, float) const { ofstub::drawCalls()++; }
+	void drawSubsection(float, float, float, float, float, float) const { ofstub::drawCalls()++; }
+	void drawSubsection(float, float, float, float, float, float, float, float) const { ofstub::drawCalls()++; }
+};
+struct ofFboSettings { int width = 0, height = 0; int internalformat = GL_RGBA; int numSamples = 0; };
+class ofFbo {
+public:
+	ofTexture tex;
+	void allocate(int w, int h, int fmt = GL_RGBA, int samples = 0) { tex.w = w; tex.h = h; }
+	void allocate(ofFboSettings s) { allocate(s.width, s.height); }
+	bool isAllocated() const { return tex.w > 0; }
+	float getWidth() const { return tex.w; }
+	float getHeight() const { return tex.h; }
+	// like oF: own viewport and identity matrix while bound
+	int savedViewport[4]; ofMatrix4x4 savedMatrix;
+	void begin(bool = true) { for (int i = 0; i < 4; ++i) savedViewport[i] = ofstubViewport()[i]; savedMatrix = ofstubCurrentMatrix(); ofstubViewport()[0] = 0; ofstubViewport()[1] = 0; ofstubViewport()[2] = tex.w; ofstubViewport()[3] = tex.h; ofstubCurrentMatrix() = ofMatrix4x4(); ofstub::fboBegins()++; }
+	void end() { for (int i = 0; i < 4; ++i) ofstubViewport()[i] = savedViewport[i]; ofstubCurrentMatrix() = savedMatrix; }
+	void draw(float, float) const { ofstub::drawCalls()++; }
+	void draw(float, float, float, float) const { ofstub::drawCalls()++; }
+	ofTexture& getTexture() { return tex; }
+	const ofTexture& getTexture() const { return tex; }
+	void clear() { tex.w = tex.h = 0; }
+};
+
+// ---- logging
+class ofLog {
+public:
+	ofLog() {}
+	ofLog(const string&) {}
+	~ofLog() { if (!ss.str().empty()) std::cerr << ss.str() << std::endl; }
+	template<class T> ofLog& operator<<(const T& v) { ss << v; return *this; }
+	stringstream ss;
+};
+class ofLogWarning : public ofLog { public: ofLogWarning() {} ofLogWarning(const string& m) {} };
+class ofLogNotice : public ofLog { public: ofLogNotice() {} ofLogNotice(const string& m) {} };
+class ofLogError : public ofLog { public: ofLogError() {} ofLogError(const string& m) {} };
+class ofLogVerbose : public ofLog { public: ofLogVerbose() {} ofLogVerbose(const string& m) {} };
+template<class T> string ofToString(const T& v) { stringstream ss; ss << v; return ss.str(); }
+template<class T> string ofToString(const T& v, int width, char fill) { stringstream ss; ss << setfill(fill) << setw(width) << v; return ss.str(); }
+inline string ofToDataPath(const string& p, bool = false) { return p; }
+inline bool ofBufferToFile(const string& path, const string& data) { ofstream f(path); f << data; return true; }
+inline float ofRandom(float a, float b) { return a + (b - a) * (rand() / (float)RAND_MAX); }
+inline float ofRandom(float b) { return ofRandom(0, b); }
+inline float ofClamp(float v, float a, float b) { return v < a ? a : v > b ? b : v; }
+inline int ofNextPow2(int a) { int r = 1; while (r < a) r <<= 1; return r; }
+inline uint32_t ofGetSystemTimeMicros() { return (uint32_t)chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count(); }
+
+class ofBaseApp { public: virtual ~ofBaseApp() {} virtual void setup() {} };
+inline void ofExit(int = 0) {}
+inline void ofSeedRandom(int s) { srand(s); }
+inline int ofToInt(const string& s) { return atoi(s.c_str()); }
+inline vector<string> ofSplitString(const string& s, const string& d, bool ignoreEmpty = false, bool = false) { vector<string> r; size_t b = 0; while (true) { size_t e = s.find(d, b); string t = s.substr(b, e == string::npos ? string::npos : e - b); if (!ignoreEmpty || !t.empty()) r.push_back(t); if (e == string::npos) break; b = e + d.size(); } return r; }
+
+inline uint64_t ofGetFixedStepForFps(double fps) { return (uint64_t)(1000000000.0 / fps); }
+inline void ofSetTimeModeFixedRate(uint64_t) {}
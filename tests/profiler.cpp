@@ -0,0 +1,58 @@
+// Chrome trace of the profiler, with class names that need escaping.
+// Built without RTTI, so the names are the ones given to ofxComponentTypeInfo.
+#include "check.h"
+#include "ofxComponent.h"
+using namespace ofxComponent;
+
+static const ofxComponentTypeInfo oddType("Odd\"Name\\With\tControl\x01", &ofxComponentBase::staticType());
+struct Odd : ofxComponentBase {
+	const ofxComponentTypeInfo& getType() const override { return oddType; }
+	void onUpdate() override {}
+};
+
+// brackets balanced outside of strings, no raw control characters in strings
+bool isWellFormed(const string& json) {
+	vector<char> stack;
+	bool inString = false;
+	for (size_t i = 0; i < json.size(); ++i) {
+		char c = json[i];
+		if (inString) {
+			if ((unsigned char)c < 0x20) return false;
+			if (c == '\\') ++i;
+			else if (c == '"') inString = false;
+			continue;
+		}
+		if (c == '"') inString = true;
+		else if (c == '[' || c == '{') stack.push_back(c);
+		else if (c == ']' || c == '}') {
+			if (stack.empty() || stack.back() != (c == ']' ? '[' : '{')) return false;
+			stack.pop_back();
+		}
+	}
+	return !inString && stack.empty();
+}
+
+int main() {
+	auto m = make_shared<ofxComponentManager>();
+	m->setup();
+	m->setProfilingEnabled(true);
+	m->addChild(make_shared<Odd>());
+	ofEventArgs e;
+	m->update(e);
+	m->update(e);
+
+	string path = "profilerTrace.json";
+	CHECK(m->saveProfileTrace(path));
+	ifstream file(path);
+	stringstream ss;
+	ss << file.rdbuf();
+	string json = ss.str();
+	remove(path.c_str());
+
+	CHECK(!json.empty());
+	CHECK(isWellFormed(json));
+	CHECK(json.find("\"Odd\\\"Name\\\\With\\tControl\\u0001::onUpdate\"") != string::npos);
+	CHECK(json.find("Odd\"Name") == string::npos);
+
+	return checkResult();
+}
@@ -0,0 +1,80 @@
+// Slot reuse and generations of component handles.
+#include "check.h"
+#include "ofxComponent.h"
+using namespace ofxComponent;
+
+class Button : public ofxComponentBase {
+	OFX_COMPONENT_TYPE(Button, ofxComponentBase)
+};
+class ToggleButton : public Button {
+	OFX_COMPONENT_TYPE(ToggleButton, Button)
+};
+
+void testSlots() {
+	ofxComponentRegistry registry;
+	auto a = make_shared<ofxComponentBase>(), b = make_shared<ofxComponentBase>();
+	auto ha = registry.insert(a), hb = registry.insert(b);
+	CHECK(ha.index != hb.index);
+	CHECK(registry.get(ha) == a.get());
+	CHECK(registry.size() == 2);
+
+	// the freed slot is reused with a new generation, the old handle stops resolving
+	CHECK(registry.remove(ha));
+	CHECK(!registry.remove(ha));
+	CHECK(registry.get(ha) == nullptr);
+	auto c = make_shared<ofxComponentBase>();
+	auto hc = registry.insert(c);
+	CHECK(hc.index == ha.index);
+	CHECK(hc.generation != ha.generation);
+	CHECK(registry.get(ha) == nullptr);
+	CHECK(registry.get(hc) == c.get());
+	CHECK(registry.get(hb) == b.get());
+
+	// dense iteration keeps the rest
+	size_t n = 0;
+	for (auto& p : registry) { CHECK(p == b || p == c); ++n; }
+	CHECK(n == 2);
+
+	// a default handle never resolves
+	CHECK(registry.get(ofxComponentRegistry::Handle()) == nullptr);
+}
+
+void testComponents() {
+	auto m = make_shared<ofxComponentManager>();
+	m->setup();
+	auto plain = make_shared<ofxComponentBase>();
+	auto button = make_shared<Button>();
+	auto toggle = make_shared<ToggleButton>();
+	m->addChild(plain);
+	m->addChild(button);
+	button->addChild(toggle);
+	ofEventArgs e; m->update(e);
+
+	auto old = toggle->getHandle();
+	CHECK(ofxComponentBase::getComponent(old) == toggle.get());
+	CHECK(ofxComponentBase::getComponentAs<Button>(old) == toggle.get());
+	CHECK(ofxComponentBase::findAll<Button>().size() == 2);
+	CHECK(ofxComponentBase::findAll<Button>(false).size() == 1);
+
+	// destroyed ones leave the type lists at once and the registry on the next update
+	toggle->destroy();
+	CHECK(ofxComponentBase::findAll<Button>().size() == 1);
+	m->update(e);
+	CHECK(ofxComponentBase::getComponent(old) == nullptr);
+
+	auto again = make_shared<ToggleButton>();
+	m->addChild(again);
+	m->update(e);
+	CHECK(again->getHandle().index == old.index);
+	CHECK(again->getHandle() != old);
+	CHECK(ofxComponentBase::getComponent(old) == nullptr);
+	CHECK(ofxComponentBase::getComponent(again->getHandle()) == again.get());
+	CHECK(ofxComponentBase::getComponent(plain->getHandle()) == plain.get());
+	CHECK(ofxComponentBase::findAll<Button>().size() == 2);
+}
+
+int main() {
+	testSlots();
+	testComponents();
+	return checkResult();
+}
@@ -0,0 +1,72 @@
+// Rebuilds of the retained draw list.
+#include "check.h"
+#include "ofxComponent.h"
+using namespace ofxComponent;
+
+int draws = 0;
+struct Drawn : ofxComponentBase {
+	void onDraw() override { ++draws; }
+};
+struct Spawning : ofxComponentBase {
+	bool spawn = false;
+	void onDraw() override {
+		++draws;
+		if (spawn) { spawn = false; addChild(make_shared<Drawn>()); }
+	}
+};
+
+int main() {
+	auto m = make_shared<ofxComponentManager>();
+	m->setup();
+	// most components don't draw, so the first frame finds out about thousands of draw interests
+	for (int i = 0; i < 2000; ++i) {
+		auto group = make_shared<ofxComponentBase>();
+		m->addChild(group);
+		if (i % 10 == 0) group->addChild(make_shared<Drawn>());
+	}
+	ofEventArgs e;
+	m->update(e);
+
+	ofxComponentRenderList list(m.get());
+	draws = 0;
+	list.draw(e);
+	CHECK(draws == 200);
+	// built once, not again for every component found not to draw
+	CHECK(list.getNumRebuilds() == 1);
+
+	// the dropped calls are left out once, then nothing changes
+	list.draw(e);
+	CHECK(list.getNumRebuilds() == 2);
+	size_t items = list.size();
+	for (int f = 0; f < 5; ++f) {
+		draws = 0;
+		m->update(e);
+		list.draw(e);
+		CHECK(draws == 200);
+	}
+	CHECK(list.getNumRebuilds() == 2);
+	CHECK(list.size() == items);
+
+	// moving doesn't rebuild
+	m->getChildren()[0]->setPos(10, 10);
+	list.draw(e);
+	CHECK(list.getNumRebuilds() == 2);
+
+	// a component added in onDraw() is drawn in the same frame, after one rebuild
+	auto spawning = make_shared<Spawning>();
+	m->addChild(spawning);
+	list.draw(e);
+	list.draw(e);
+	unsigned int before = list.getNumRebuilds();
+	spawning->spawn = true;
+	draws = 0;
+	list.draw(e);
+	CHECK(draws == 202);
+	CHECK(list.getNumRebuilds() == before + 1);
+	// and its postDraw() is dropped in the next one
+	list.draw(e);
+	list.draw(e);
+	CHECK(list.getNumRebuilds() == before + 2);
+
+	return checkResult();
+}
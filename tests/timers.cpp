@@ -0,0 +1,101 @@
+// Order of timers, and cancel / pause through TimerRef.
+#include "check.h"
+#include "ofxComponent.h"
+using namespace ofxComponent;
+
+vector<string> fired;
+
+struct Arming : ofxComponentBase {
+	bool armed = false;
+	void onUpdate() override {
+		if (!armed) return;
+		armed = false;
+		addTimerFunction([] { fired.push_back("zero"); }, 0);
+	}
+};
+
+int main() {
+	auto m = make_shared<ofxComponentManager>();
+	m->setup();
+	auto a = make_shared<Arming>();
+	m->addChild(a);
+	ofEventArgs e;
+	ofstub::now() = 0;
+	m->update(e);
+
+	auto step = [&](float t) { ofstub::now() = t; m->update(e); };
+
+	// by exec time across frames
+	a->addTimerFunction([] { fired.push_back("c"); }, 0.3);
+	a->addTimerFunction([] { fired.push_back("a"); }, 0.1);
+	a->addTimerFunction([] { fired.push_back("b"); }, 0.2);
+	for (float t = 0.05; t < 0.5; t += 0.05) step(t);
+	CHECK((fired == vector<string>{ "a", "b", "c" }));
+
+	// elapsed in the same frame: in the order they were added
+	fired.clear();
+	a->addTimerFunction([] { fired.push_back("late"); }, 0.2);
+	a->addTimerFunction([] { fired.push_back("early"); }, 0.1);
+	step(1.0);
+	CHECK((fired == vector<string>{ "late", "early" }));
+
+	// added during the update with no wait: next frame
+	fired.clear();
+	a->armed = true;
+	step(1.1);
+	CHECK(fired.empty());
+	step(1.2);
+	CHECK((fired == vector<string>{ "zero" }));
+
+	// cancel releases the callback and its captures at once
+	fired.clear();
+	auto captured = make_shared<int>(0);
+	auto t = a->addTimerFunction([captured] { fired.push_back("canceled"); }, 0.1);
+	CHECK(captured.use_count() == 2);
+	CHECK(!t->isDone());
+	t->cancel();
+	CHECK(t->isDone());
+	CHECK(captured.use_count() == 1);
+	step(2.0);
+	CHECK(fired.empty());
+	// still safe once it is released after the next timer ran
+	a->addTimerFunction([] {}, 0);
+	step(2.05);
+	CHECK(!t.isAlive());
+	t->cancel();
+	CHECK(t->isDone());
+	CHECK(t->getExecTime() == 0);
+
+	// cancel from its own callback
+	ofxComponentBase::TimerRef self;
+	auto captured2 = make_shared<int>(0);
+	self = a->addTimerFunction([captured2, &self] { self->cancel(); fired.push_back("self"); }, 0);
+	step(2.1);
+	CHECK((fired == vector<string>{ "self" }));
+	CHECK(self->isDone());
+	CHECK(captured2.use_count() == 1);
+
+	// paused timers wait and keep their remaining time
+	fired.clear();
+	auto p = a->addTimerFunction([] { fired.push_back("paused"); }, 0.2);
+	step(2.2);
+	p->setPaused(true);
+	CHECK(p->isPaused());
+	step(3.0);
+	CHECK(fired.empty());
+	p->setPaused(false);
+	step(3.05);
+	CHECK(fired.empty());
+	step(3.2);
+	CHECK((fired == vector<string>{ "paused" }));
+
+	// canceled before its owner is destroyed, nothing runs
+	fired.clear();
+	auto d = a->addTimerFunction([] { fired.push_back("destroyed"); }, 0.1);
+	a->destroy();
+	step(4.0);
+	CHECK(fired.empty());
+	CHECK(d->isDone());
+
+	return checkResult();
+}